@@ -0,0 +1,187 @@
+// AllocTracker.cpp:                                           HDO, 2021
+// ----------------
+// Tracking of all heap allocations via replacement of the global
+// operator new/delete (only if ALLOC_COUNTING is defined, see
+// AllocTracker.h), AllocScope and phase records of ScopedAllocTracker.
+//======================================================================
+
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+
+using namespace std;
+
+#include "AllocTracker.h"
+
+
+// replacement of global operator new/delete
+//------------------------------------------
+// each block has a header with its size, so operator delete knows the
+// nr. of bytes freed, counters of the current thread are thread_local
+// with trivial types, so accessing them never allocates
+
+static thread_local long      tlAllocs = 0; // allocations of this thread
+static thread_local long long tlBytes  = 0; // bytes allocated by this thread
+static thread_local long long tlLive   = 0; // allocated - freed bytes
+static thread_local long long tlPeak   = 0; // max. of tlLive in innermost scope
+
+#ifdef ALLOC_COUNTING
+
+// GCC warns about free on pointers from operator new where it inlines
+//   the replacements below, but these pointers come from malloc
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+  #pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+
+// allocation counts for allocationCount, sharded like the counters of
+//   ObjectCounter: each thread increments "its" shard only (one cache
+//   line per shard, so no false sharing), summed on demand
+
+const int nAllocShards = 64;
+
+struct alignas(64) AllocShard {
+  atomic<long> nAllocations{0};
+}; // AllocShard
+
+static AllocShard allocShards[nAllocShards]; // constant initialization
+
+static int allocShardIdx() { // shard index of the calling thread
+  static atomic<int> nextIdx(0);
+  static thread_local int idx = -1; // trivial, so no allocation
+  if (idx < 0)
+    idx = nextIdx.fetch_add(1, memory_order_relaxed) % nAllocShards;
+  return idx;
+} // allocShardIdx
+
+static const size_t headerSize = alignof(max_align_t); // keeps alignment
+
+long allocationCount() {
+  long sum = 0;
+  for (const AllocShard &s: allocShards)
+    sum += s.nAllocations.load(memory_order_relaxed);
+  return sum;
+} // allocationCount
+
+void *operator new(size_t size) {
+  char *p = (char *)malloc(headerSize + size);
+  if (p == nullptr)
+    throw bad_alloc();
+  *(size_t *)p = size;
+  allocShards[allocShardIdx()].nAllocations.fetch_add(1, memory_order_relaxed);
+  tlAllocs++;
+  tlBytes += size;
+  tlLive  += size;
+  if (tlLive > tlPeak)
+    tlPeak = tlLive;
+  return p + headerSize;
+} // operator new
+
+void operator delete(void *p) noexcept {
+  if (p == nullptr)
+    return;
+  char *block = (char *)p - headerSize;
+  tlLive -= *(size_t *)block; // freed by other thread: may get negative
+  free(block);
+} // operator delete
+
+void operator delete(void *p, size_t /*size*/) noexcept {
+  operator delete(p);
+} // operator delete
+
+#else // no replacement, so nothing to count
+
+long allocationCount() {
+  return 0;
+} // allocationCount
+
+#endif // ALLOC_COUNTING
+
+
+// --- implementation of class AllocScope ---
+
+AllocScope::AllocScope()
+: startAllocs(tlAllocs), startBytes(tlBytes), startLive(tlLive),
+  outerPeak(tlPeak) {
+  tlPeak = tlLive;         // peak of this scope starts now
+} // AllocScope::AllocScope
+
+AllocScope::~AllocScope() {
+  tlPeak = max(outerPeak, tlPeak); // peak of enclosing scope
+} // AllocScope::~AllocScope
+
+AllocStats AllocScope::stats() const {
+  return {tlAllocs - startAllocs, tlBytes - startBytes, tlPeak - startLive};
+} // AllocScope::stats
+
+
+// --- implementation of class ScopedAllocTracker ---
+
+// stats of all runs per phase, printed on destruction at exit
+struct AllocPhaseTable {
+  struct Entry {
+    long      runs = 0;
+    AllocStats sum = {0, 0, 0}; // peakBytes: max. over all runs
+  }; // Entry
+  mutex mtx;
+  map<string, Entry> phases;
+  ~AllocPhaseTable() {
+    if (!phases.empty())
+      printAllocPhases(cout);
+  } // ~AllocPhaseTable
+}; // AllocPhaseTable
+
+static AllocPhaseTable &allocPhaseTable() {
+  static AllocPhaseTable apt; // constructed on first use
+  return apt;
+} // allocPhaseTable
+
+
+ScopedAllocTracker::ScopedAllocTracker(const char *phase)
+: phase(phase) {
+} // ScopedAllocTracker::ScopedAllocTracker
+
+ScopedAllocTracker::~ScopedAllocTracker() {
+  recordAllocPhase(phase, scope.stats());
+} // ScopedAllocTracker::~ScopedAllocTracker
+
+
+void recordAllocPhase(const char *phase, const AllocStats &as) {
+  AllocPhaseTable &apt = allocPhaseTable();
+  lock_guard<mutex> lock(apt.mtx);
+  AllocPhaseTable::Entry &e = apt.phases[phase];
+  e.runs++;
+  e.sum.allocations += as.allocations;
+  e.sum.bytes       += as.bytes;
+  e.sum.peakBytes    = max(e.sum.peakBytes, as.peakBytes);
+} // recordAllocPhase
+
+void printAllocPhases(ostream &os) {
+  AllocPhaseTable &apt = allocPhaseTable();
+  lock_guard<mutex> lock(apt.mtx);
+  ios_base::fmtflags flags = os.flags();
+  os << endl << "allocations per run of phase:" << endl;
+  os << left << setw(32) << "phase" << right << setw(8) << "runs" <<
+        setw(14) << "allocs/run" << setw(14) << "bytes/run" <<
+        setw(14) << "max. peak" << endl;
+  os << fixed << setprecision(1);
+  for (auto &pe: apt.phases) {
+    const AllocPhaseTable::Entry &e = pe.second;
+    os << left << setw(32) << pe.first << right << setw(8) << e.runs <<
+          setw(14) << (double)e.sum.allocations / e.runs <<
+          setw(14) << (double)e.sum.bytes       / e.runs <<
+          setw(14) << e.sum.peakBytes << endl;
+  } // for
+  os.flags(flags);
+} // printAllocPhases
+
+
+// end of AllocTracker.cpp
+//======================================================================
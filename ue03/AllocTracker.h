@@ -0,0 +1,110 @@
+// AllocTracker.h:                                             HDO, 2021
+// --------------
+// Tracking of all heap allocations via replacement of the global
+// operator new/delete (incl. those of std::string, std::map, etc.,
+// which ObjectCounter does not see):
+// * allocationCount() returns the nr. of allocations of all threads,
+// * an AllocScope measures allocations, allocated bytes and the peak of
+//   live bytes of the calling thread from its construction on, and
+// * ScopedAllocTracker (and macro TRACK_ALLOCATIONS) records these per
+//   named phase, at program exit a summary per phase is printed.
+// The replacement costs a header per block and counter updates on each
+// allocation, so it is compiled in only if ALLOC_COUNTING is defined
+// (e.g., in the preprocessor definitions of the Debug configurations or
+// via -DALLOC_COUNTING for benchmarks), ALLOC_TRACKING implies it.
+// Otherwise all counts and stats are zero.
+// AllocScope and TRACK_ALLOCATIONS see the calling thread only, so
+// phases that fan out to worker threads (e.g., NFA::dfaOfParallel or
+// NFA::renamedMinimalDfaOf with nThreads != 1) are under-reported.
+//======================================================================
+
+#ifndef AllocTracker_h
+#define AllocTracker_h
+
+#include <iosfwd>
+
+#include "ObjectCounter.h"
+
+
+#if defined(ALLOC_TRACKING) && !defined(ALLOC_COUNTING)
+  #define ALLOC_COUNTING
+#endif
+
+constexpr bool allocationCounting() { // operator new/delete replaced?
+#ifdef ALLOC_COUNTING
+  return true;
+#else
+  return false;
+#endif
+} // allocationCounting
+
+long allocationCount(); // nr. of calls of operator new so far, all threads
+                        //   (sum of per-thread counters), 0 if not counting
+
+
+struct AllocStats {
+  long      allocations;   // nr. of allocations
+  long long bytes;         // sum of allocated bytes
+  long long peakBytes;     // max. of live bytes (allocated - freed)
+}; // AllocStats
+
+
+class AllocScope final // no public base class
+        /*OC+*/ : private ObjectCounter<AllocScope> /*+OC*/ {
+
+  private:
+
+    long      startAllocs;
+    long long startBytes, startLive, outerPeak;
+
+  public:
+
+    AllocScope();  // scopes of one thread have to be nested
+
+    AllocScope(const AllocScope &as) = delete;
+    AllocScope &operator=(const AllocScope &as) = delete;
+
+    ~AllocScope();
+
+    AllocStats stats() const; // of calling thread since construction,
+                              //   allocations of other threads not incl.
+
+}; // AllocScope
+
+
+class ScopedAllocTracker final // no public base class
+        /*OC+*/ : private ObjectCounter<ScopedAllocTracker> /*+OC*/ {
+
+  private:
+
+    const char *phase;     // name of phase, a string literal
+    AllocScope  scope;
+
+  public:
+
+    explicit ScopedAllocTracker(const char *phase);
+
+    ScopedAllocTracker(const ScopedAllocTracker &sat) = delete;
+    ScopedAllocTracker &operator=(const ScopedAllocTracker &sat) = delete;
+
+    ~ScopedAllocTracker(); // records stats of scope for phase
+
+}; // ScopedAllocTracker
+
+void recordAllocPhase(const char *phase, const AllocStats &as);
+void printAllocPhases(std::ostream &os); // summary of all phases so far
+
+// TRACK_ALLOCATIONS(phase) tracks the allocations of the calling thread
+//   in the rest of the enclosing block if ALLOC_TRACKING is defined,
+//   otherwise it expands to nothing
+#ifdef ALLOC_TRACKING
+  #define TRACK_ALLOCATIONS(phase) ScopedAllocTracker allocTracker_(phase)
+#else
+  #define TRACK_ALLOCATIONS(phase)
+#endif
+
+
+#endif
+
+// end of AllocTracker.h
+//======================================================================
@@ -0,0 +1,81 @@
+// Arena.cpp:                                                  HDO, 2021
+// ---------
+// An Arena provides a monotonic buffer (std::pmr::memory_resource) for
+// the temporary data structures of one transformation of an automaton,
+// e.g., in NFA::dfaOf: the pmr-aware StateSets, MbMatrixes (Deltas) and
+// FABuilders allocate their nodes from the arena and all memory is
+// released at once when the arena is destroyed.
+// CountingResource is a memory_resource that counts the allocations it
+// forwards to its upstream resource.
+//======================================================================
+
+#include <memory_resource>
+
+using namespace std;
+
+#include "Arena.h"
+
+
+// --- implementation of class CountingResource ---
+
+CountingResource::CountingResource(pmr::memory_resource *upstream)
+: upstream(upstream), nAllocs(0), nBytes(0) {
+} // CountingResource::CountingResource
+
+
+void *CountingResource::do_allocate(size_t bytes, size_t alignment) {
+  nAllocs.fetch_add(1,     memory_order_relaxed);
+  nBytes .fetch_add(bytes, memory_order_relaxed);
+  return upstream->allocate(bytes, alignment);
+} // CountingResource::do_allocate
+
+void CountingResource::do_deallocate(void *p, size_t bytes, size_t alignment) {
+  upstream->deallocate(p, bytes, alignment);
+} // CountingResource::do_deallocate
+
+bool CountingResource::do_is_equal(const pmr::memory_resource &other) const noexcept {
+  return this == &other;
+} // CountingResource::do_is_equal
+
+
+size_t CountingResource::allocations() const {
+  return nAllocs.load(memory_order_relaxed);
+} // CountingResource::allocations
+
+size_t CountingResource::bytes() const {
+  return nBytes.load(memory_order_relaxed);
+} // CountingResource::bytes
+
+
+void CountingResource::reset() {
+  nAllocs = 0;
+  nBytes  = 0;
+} // CountingResource::reset
+
+
+// --- implementation of class Arena ---
+
+bool Arena::enabled = true;
+
+
+Arena::Arena(size_t initialSize)
+: mbr(initialSize), // upstream of mbr is the current default resource
+  counter(&mbr) {
+} // Arena::Arena
+
+
+pmr::memory_resource *Arena::resource() {
+  if (enabled)
+    return &counter;
+  else
+    return pmr::get_default_resource();
+} // Arena::resource
+
+
+size_t Arena::allocations() const {
+  return counter.allocations();
+} // Arena::allocations
+
+
+// end of Arena.cpp
+//======================================================================
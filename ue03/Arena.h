@@ -0,0 +1,83 @@
+// Arena.h:                                                    HDO, 2021
+// -------
+// An Arena provides a monotonic buffer (std::pmr::memory_resource) for
+// the temporary data structures of one transformation of an automaton,
+// e.g., in NFA::dfaOf: the pmr-aware StateSets, MbMatrixes (Deltas) and
+// FABuilders allocate their nodes from the arena and all memory is
+// released at once when the arena is destroyed.
+// An Arena is not thread safe, so use one arena per thread.
+// CountingResource is a memory_resource that counts the allocations it
+// forwards to its upstream resource.
+//======================================================================
+
+#ifndef Arena_h
+#define Arena_h
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+#include "ObjectCounter.h"
+
+
+class CountingResource final: public std::pmr::memory_resource
+                 /*OC+*/ , private ObjectCounter<CountingResource> /*+OC*/ {
+
+  private:
+
+    std::pmr::memory_resource *upstream;
+    std::atomic<std::size_t>   nAllocs, nBytes;
+
+  protected:
+
+    void *do_allocate  (std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool  do_is_equal  (const std::pmr::memory_resource &other) const noexcept override;
+
+  public:
+
+    CountingResource(std::pmr::memory_resource *upstream =
+                       std::pmr::get_default_resource());
+
+    CountingResource(const CountingResource &cr) = delete;
+    CountingResource &operator=(const CountingResource &cr) = delete;
+
+    std::size_t allocations() const; // nr. of allocations so far
+    std::size_t bytes()       const; // sum of allocated bytes so far
+
+    void reset();
+
+}; // CountingResource
+
+
+class Arena final // no public base class
+        /*OC+*/ : private ObjectCounter<Arena> /*+OC*/ {
+
+  private:
+
+    std::pmr::monotonic_buffer_resource mbr;
+    CountingResource                    counter; // counts requests to mbr
+
+  public:
+
+    static bool enabled; // false: resource() returns the default resource,
+                         //   e.g., to compare allocation counts
+
+    Arena(std::size_t initialSize = 64 * 1024);
+
+    Arena(const Arena &a) = delete;
+    Arena &operator=(const Arena &a) = delete;
+
+    ~Arena() = default; // releases all memory, no virtual as class is final
+
+    std::pmr::memory_resource *resource();
+
+    std::size_t allocations() const; // nr. of allocations served by arena
+
+}; // Arena
+
+
+#endif
+
+// end of Arena.h
+//======================================================================
@@ -0,0 +1,514 @@
+// Benchmark.cpp:                                              HDO, 2021
+// -------------
+// In-tree benchmark harness and suite for the finite automata classes:
+// * measure(f) calls f repeatedly until a minimal run time is reached
+//   and returns the average time and number of allocations per call
+//   plus hardware counters (see PerfCounters.h) if available,
+// * printMeasurement prints one line of results (including ns/symbol
+//   and throughput for acceptance tests) and
+// * runBenchmarks runs the whole suite, started via
+//     ue03 -bench [filter]
+//   where only benchmarks with filter in their name are run.
+// Results depend on the build configuration, so compare builds with
+// and without NO_OBJECT_COUNTING (see ObjectCounter.h).
+//======================================================================
+
+#include <cctype>
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "ObjectCounter.h"
+#include "Arena.h"
+#include "TapeStuff.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "Moore.h"
+#include "Mealy.h"
+#include "MultiMatcher.h"
+#include "FABuilder.h"
+#include "FAGenerator.h"
+#include "GrammarBuilder.h"
+#include "Grammar.h"
+#include "Benchmark.h"
+
+
+// harness
+//--------
+
+void printMeasurement(const string &name, const string &params,
+                      const Measurement &m, long symbolsPerCall) {
+  ios::fmtflags flags     = cout.flags();
+  streamsize    precision = cout.precision();
+  cout << fixed << left << setw(26) << name << setw(22) << params << right;
+  if (m.nsPerCall >= 1e6)
+    cout << setw(10) << setprecision(2) << m.nsPerCall / 1e6 << " ms/call ";
+  else
+    cout << setw(10) << setprecision(0) << m.nsPerCall       << " ns/call ";
+  if (symbolsPerCall > 0)
+    cout << setw(9) << setprecision(1) << m.nsPerCall / symbolsPerCall <<
+            " ns/sy " <<
+            setw(8) << setprecision(1) << 1e3 * symbolsPerCall / m.nsPerCall <<
+            " Msy/s";
+  else
+    cout << setw(25) << "";
+  if (allocationCounting())
+    cout << setw(11) << setprecision(1) << m.allocsPerCall << " allocs/call";
+  else
+    cout << setw(23) << "";
+  if (m.counters.valid) {  // per symbol for acceptance tests, else per call
+    double per = (double)m.calls * (symbolsPerCall > 0 ? symbolsPerCall : 1);
+    const char *unit = symbolsPerCall > 0 ? "/sy" : "/call";
+    cout << setw(10) << setprecision(1) << m.counters.instructions / per <<
+            " instr" << unit <<
+            setw(6) << setprecision(2) <<
+            (m.counters.cycles > 0 ?
+               (double)m.counters.instructions / m.counters.cycles : 0.0) <<
+            " IPC" <<
+            setw(9) << setprecision(3) << m.counters.cacheMisses  / per <<
+            " cache-misses" << unit <<
+            setw(9) << setprecision(3) << m.counters.branchMisses / per <<
+            " branch-misses" << unit;
+  } // if
+  cout << endl;
+  cout.flags(flags);
+  cout.precision(precision);
+} // printMeasurement
+
+
+// automata and tapes for the benchmarks
+//--------------------------------------
+
+// NFA for L = {a, b}* a {a, b}^(n - 1), i.e., the n-th symbol from the
+//   end is an a: up to n + 1 states are active at once (ambiguity n) and
+//   its DFA has 2^n states (worst case for subset construction)
+static NFA *nthFromEndNFA(int n) {
+  return FABuilder(FAGenerator::nthFromEndText(n).c_str()).buildNFA();
+} // nthFromEndNFA
+
+static Tape randomTape(int len, const string &alphabet, unsigned seed) {
+  mt19937 rng(seed);
+  uniform_int_distribution<size_t> dist(0, alphabet.length() - 1);
+  Tape tape(len, ' ');
+  for (char &tSy: tape)
+    tSy = alphabet[dist(rng)];
+  return tape;
+} // randomTape
+
+static string params(int n, int len = -1) {
+  string p = "n = " + to_string(n);
+  if (len >= 0)
+    p += ", |tape| = " + to_string(len);
+  return p;
+} // params
+
+
+// counts the allocations of the pmr-aware containers (StateSet, MbMatrix,
+//   etc.) in transformation t without and with Arenas for its temporaries
+template<typename Transformation>
+static void reportArenaAllocations(const string &name, Transformation t) {
+  CountingResource  counter;
+  pmr::memory_resource *prev = pmr::set_default_resource(&counter);
+  size_t nAllocs[2];
+  for (int withArena = 0; withArena <= 1; withArena++) {
+    Arena::enabled = (withArena == 1);
+    counter.reset();
+    delete t();
+    nAllocs[withArena] = counter.allocations();
+  } // for
+  Arena::enabled = true;
+  pmr::set_default_resource(prev);
+  cout << left << setw(24) << name << right <<
+          nAllocs[0] << " pmr allocations without arena, " <<
+          nAllocs[1] << " with arena" << endl;
+} // reportArenaAllocations
+
+// allocations (incl. those of std::string etc.) and peak of live bytes
+//   of one call of f, f returns an object to be deleted afterwards
+template<typename Func>
+static void reportAllocations(const string &name, const string &params,
+                              Func f) {
+  delete f();              // warm up (lazy initializations)
+  AllocStats as;
+  {
+    AllocScope scope;
+    auto result = f();
+    as = scope.stats();
+    delete result;
+  }
+  cout << left << setw(36) << name << setw(10) << params << right <<
+          setw(8)  << as.allocations << " allocs " <<
+          setw(10) << as.bytes       << " bytes " <<
+          setw(10) << as.peakBytes   << " peak bytes" << endl;
+} // reportAllocations
+
+static string objectCountingMode() {
+#ifndef DO_OBJECT_COUNTING
+  return "off";
+#elif defined(LOG_OBJECTS)
+  return "on (with object logging)";
+#else
+  return "on (counters only)";
+#endif
+} // objectCountingMode
+
+
+// the benchmark suite
+//--------------------
+
+void runBenchmarks(const string &filter) {
+  auto selected = [&filter](const string &name) {
+    return name.find(filter) != string::npos;
+  }; // selected
+  volatile bool sink = false; // keeps the optimizer from dropping calls
+
+  cout << "benchmarks, object counting: " << objectCountingMode() << endl;
+  PerfCounters pc;
+  cout << "hardware counters: " <<
+          (pc.available() ? "available" : "not available, " + pc.reason()) <<
+          endl;
+  cout << endl;
+
+  // acceptance tests, n: ambiguity (and size) of automaton
+  for (int n: {4, 8}) {
+    NFA *nfa = nthFromEndNFA(n);
+    DFA *dfa = nfa->dfaOf();
+    NFA::Simulator sim(*nfa);
+    for (int len: {100, 10000}) {
+      const Tape tape = randomTape(len, "ab", 4711 + len);
+      if (selected("DFA::accepts"))
+        printMeasurement("DFA::accepts", params(n, len),
+          measure([&] { sink = dfa->accepts(tape); }), len);
+      if (selected("NFA::accepts2") && len <= 1000) // deep recursion
+        printMeasurement("NFA::accepts2", params(n, len),
+          measure([&] { sink = nfa->accepts2(tape); }), len);
+      if (selected("NFA::accepts3"))
+        printMeasurement("NFA::accepts3", params(n, len),
+          measure([&] { sink = nfa->accepts3(tape); }), len);
+      if (selected("NFA::Simulator::accepts"))
+        printMeasurement("NFA::Simulator::accepts", params(n, len),
+          measure([&] { sink = sim.accepts(tape); }), len);
+    } // for
+    if (selected("DFA::accepts")) { // long tape for DFA only
+      const int  len  = 1000000;
+      const Tape tape = randomTape(len, "ab", 4711 + len);
+      printMeasurement("DFA::accepts", params(n, len),
+        measure([&] { sink = dfa->accepts(tape); }), len);
+    } // if
+    delete dfa;
+    delete nfa;
+  } // for
+
+  // many patterns (random DFAs) at once, n: nr. of patterns: accepts for
+  //   each pattern vs. one pass of MultiMatcher (lazy union DFA)
+  if (selected("MultiMatcher")) {
+    const int nPatterns = 200;
+    vector<const FA *> patterns;
+    for (int i = 0; i < nPatterns; i++) {
+      FAGenerator gen(4711 + i);
+      gen.setNrOfStates(8).setAlphabetSize(2).setDensity(1.0);
+      patterns.push_back(FABuilder(gen.dfaText().c_str()).buildDFA());
+    } // for
+    MultiMatcher mm(patterns);
+    for (int len: {10, 1000}) {
+      const Tape tape = randomTape(len, "ab", 4711 + len);
+      const string p = params(nPatterns, len);
+      printMeasurement("DFA::accepts (each)", p,
+        measure([&] {
+          for (const FA *fa: patterns)
+            sink = fa->accepts(tape);
+        }), len);
+      printMeasurement("MultiMatcher::matches", p,
+        measure([&] { sink = mm.matches(tape).empty(); }), len);
+    } // for
+    cout << "MultiMatcher: " << mm.nrOfCachedStates() << " cached states, " <<
+            mm.nrOfFlushes() << " flushes" << endl;
+    for (const FA *fa: patterns)
+      delete fa;
+    cout << endl;
+  } // if
+
+  // transductions of Moore machine (DFA of nthFromEndNFA(8)) with output
+  //   of last symbol: via accepts (cout to a null stream buffer)
+  //   vs. transduce vs. compiled table
+  if (selected("Moore")) {
+    NFA *nfa = nthFromEndNFA(8);
+    DFA *dfa = nfa->dfaOf();
+    ostringstream oss;
+    oss << *dfa;
+    map<State, char> lambda;
+    for (const auto &t: dfa->delta.transitions())
+      lambda[t.dest] = t.tSy;
+    FABuilder fab(oss.str().c_str());
+    fab.setLambda(lambda);
+    Moore *moore = fab.buildMoore();
+    const CompiledMoore compiled(*moore);
+    for (int len: {100, 10000}) {
+      const Tape tape = randomTape(len, "ab", 4711 + len);
+      string out;
+      struct NullBuf: streambuf {
+        int overflow(int ch) override { return ch; }
+      } nullBuf;
+      streambuf *prev = cout.rdbuf(&nullBuf);
+      Measurement m = measure([&] { sink = moore->accepts(tape); });
+      cout.rdbuf(prev);
+      printMeasurement("Moore::accepts", params(8, len), m, len);
+      printMeasurement("Moore::transduce", params(8, len),
+        measure([&] { out.clear(); sink = moore->transduce(tape, out); }), len);
+      printMeasurement("CompiledMoore::transduce", params(8, len),
+        measure([&] { out.clear(); sink = compiled.transduce(tape, out); }),
+        len);
+    } // for
+    delete moore;
+    delete dfa;
+    delete nfa;
+    cout << endl;
+  } // if
+
+  // transductions of Mealy machine (same DFA) with upper case symbols as
+  //   output: output in blocks via OutputSink
+  if (selected("Mealy")) {
+    NFA *nfa = nthFromEndNFA(8);
+    DFA *dfa = nfa->dfaOf();
+    ostringstream oss;
+    oss << *dfa;
+    map<pair<State, TapeSymbol>, char> lambda;
+    for (const auto &t: dfa->delta.transitions())
+      lambda[{t.src, t.tSy}] = (char)toupper(t.tSy);
+    FABuilder fab(oss.str().c_str());
+    fab.setMealyLambda(lambda);
+    Mealy *mealy = fab.buildMealy();
+    for (int len: {100, 10000}) {
+      const Tape tape = randomTape(len, "ab", 4711 + len);
+      StringSink out;
+      printMeasurement("Mealy::transduce", params(8, len),
+        measure([&] { out.str.clear(); sink = mealy->transduce(tape, out); }),
+        len);
+    } // for
+    delete mealy;
+    delete dfa;
+    delete nfa;
+    cout << endl;
+  } // if
+
+  if (selected("NFA::accepts1"))  // one thread per transition, so short tapes
+    for (int n: {2, 4}) {
+      NFA *nfa = nthFromEndNFA(n);
+      for (int len: {16, 64}) {
+        const Tape tape = randomTape(len, "ab", 4711 + len);
+        printMeasurement("NFA::accepts1", params(n, len),
+          measure([&] { sink = nfa->accepts1(tape); }), len);
+      } // for
+      delete nfa;
+    } // for
+  cout << endl;
+
+  // transformations, n: size of NFA, DFAs have 2^n states
+  for (int n: {4, 8, 10}) {
+    NFA *nfa = nthFromEndNFA(n);
+    DFA *dfa = nfa->dfaOf();
+    if (selected("NFA::dfaOf"))
+      printMeasurement("NFA::dfaOf", params(n),
+        measure([&] { delete nfa->dfaOf(); }));
+    if (selected("NFA::dfaOfParallel"))
+      printMeasurement("NFA::dfaOfParallel", params(n),
+        measure([&] { delete nfa->dfaOfParallel(); }));
+    if (selected("NFA::brzozowskiOf"))
+      printMeasurement("NFA::brzozowskiOf", params(n),
+        measure([&] { delete nfa->brzozowskiOf(); }));
+    if (selected("NFA::minimalDfaOf"))
+      printMeasurement("NFA::minimalDfaOf", params(n),
+        measure([&] { delete nfa->minimalDfaOf(); }));
+    if (selected("NFA::renamedMinimalDfaOf"))
+      printMeasurement("NFA::renamedMinimalDfaOf", params(n),
+        measure([&] { delete nfa->renamedMinimalDfaOf(); }));
+    if (selected("DFA::minimalOf") && n <= 8) // O(|S|^2) table
+      printMeasurement("DFA::minimalOf", params(n),
+        measure([&] { delete dfa->minimalOf(); }));
+    if (selected("DFA::minimalOfParallel"))
+      printMeasurement("DFA::minimalOfParallel", params(n),
+        measure([&] { delete dfa->minimalOfParallel(); }));
+    if (selected("DFA::renamedOf"))
+      printMeasurement("DFA::renamedOf", params(n),
+        measure([&] { delete dfa->renamedOf(); }));
+    if (selected("FA::")) {           // language queries on the DFA
+      Tape witness;
+      printMeasurement("FA::shortestWitness", params(n),
+        measure([&] { sink = dfa->shortestWitness(witness); }));
+      printMeasurement("FA::isFinite", params(n),
+        measure([&] { sink = dfa->isFinite(); }));
+      printMeasurement("FA::bfsOrder", params(n),
+        measure([&] { sink = dfa->bfsOrder().size() > 0; }));
+      printMeasurement("FA::operator<<", params(n),
+        measure([&] { ostringstream oss; oss << *dfa; sink = oss.good(); }));
+      printMeasurement("FA::writeGraphViz", params(n),
+        measure([&] { ostringstream oss; dfa->writeGraphViz(oss);
+                      sink = oss.good(); }));
+    } // if
+    if (selected("DFA::count")) {     // accepted tapes of lengths <= 1000
+      const uint64_t p = 1000000007;
+      printMeasurement("DFA::countsUpTo", params(n, 1000),
+        measure([&] { sink = dfa->countsUpTo(1000).back().isZero(); }));
+      printMeasurement("DFA::countsModuloUpTo", params(n, 1000),
+        measure([&] { sink = dfa->countsModuloUpTo(1000, p).back() == 0; }));
+      if (n <= 4)          // O(|S|^3 log length), but for huge lengths
+        printMeasurement("DFA::countModulo", "n = 4, |tape| = 1e18",
+          measure([&] { sink = dfa->countModulo(1000000000000000000ull, p)
+                               == 0; }));
+    } // if
+    if (selected("DFA::TapeEnumerator")) { // first 10000 accepted tapes
+      printMeasurement("DFA::TapeEnumerator", params(n, 20),
+        measure([&] {
+          DFA::TapeEnumerator te(*dfa, 20);
+          Tape tape;
+          for (int i = 0; i < 10000 && te.next(tape); i++)
+            sink = tape.empty();
+        }));
+    } // if
+    if (selected("equivalent")) {     // DFA and its minimal DFA
+      DFA *minDfa = dfa->minimalOfParallel();
+      printMeasurement("equivalent", params(n),
+        measure([&] { sink = equivalent(*dfa, *minDfa); }));
+      delete minDfa;
+    } // if
+    if (selected("included")) {       // NFA and NFA for n + 1 (not incl.)
+      NFA *other = nthFromEndNFA(n + 1);
+      printMeasurement("included (true)", params(n),
+        measure([&] { sink = included(*nfa, *nfa); }));
+      printMeasurement("included (false)", params(n),
+        measure([&] { sink = included(*nfa, *other); }));
+      delete other;
+    } // if
+    if (selected("DFA::intersect")) { // with complement of DFA for n - 1
+      NFA *other    = nthFromEndNFA(n - 1);
+      DFA *otherDfa = other->dfaOf();
+      DFA *rest     = otherDfa->complement();
+      printMeasurement("DFA::intersect", params(n),
+        measure([&] { delete dfa->intersect(*rest); }));
+      printMeasurement("DFA::intersect (minimal)", params(n),
+        measure([&] { delete dfa->intersect(*rest, true); }));
+      delete rest;
+      delete otherDfa;
+      delete other;
+    } // if
+    if (selected("DFA::complement"))
+      printMeasurement("DFA::complement", params(n),
+        measure([&] { delete dfa->complement(); }));
+    delete dfa;
+    delete nfa;
+  } // for
+
+  // transformations of random automata, n: nr. of states, alphabet {a, b, c},
+  //   DFAs of random NFAs grow exponentially, so only small NFAs
+  if (selected("random")) {
+    for (int n: {8, 12, 16}) {
+      FAGenerator gen;
+      gen.setNrOfStates(n).setAlphabetSize(3);
+      NFA *nfa = FABuilder(gen.nfaText().c_str()).buildNFA();
+      printMeasurement("random NFA::dfaOf", params(n),
+        measure([&] { delete nfa->dfaOf(); }));
+      printMeasurement("random NFA::minimalDfaOf", params(n),
+        measure([&] { delete nfa->minimalDfaOf(); }));
+      delete nfa;
+    } // for
+    for (int n: {16, 32, 64}) {
+      FAGenerator gen;
+      gen.setNrOfStates(n).setAlphabetSize(3);
+      DFA *dfa = FABuilder(gen.dfaText().c_str()).buildDFA();
+      printMeasurement("random DFA::minimalOf", params(n),
+        measure([&] { delete dfa->minimalOf(); }));
+      delete dfa;
+    } // for
+    { // language {eps}: trimming leaves no transitions, so no FABuilder
+      FABuilder fab;
+      fab.addTransition("S", 'a', "T");
+      fab.setStartState("S");
+      fab.addFinalState("S");
+      NFA *nfa = fab.buildNFA();
+      printMeasurement("{eps} NFA::brzozowskiOf", params(2),
+        measure([&] { delete nfa->brzozowskiOf(); }));
+      printMeasurement("{eps} NFA::minimalDfaOf", params(2),
+        measure([&] { delete nfa->minimalDfaOf(); }));
+      delete nfa;
+    } // block
+    cout << endl;
+  } // if
+
+  // parsing of automata in text form, n: size of NFA
+  if (selected("FABuilder"))
+    for (int n: {8, 64, 512}) {
+      NFA *nfa = nthFromEndNFA(n);
+      ostringstream oss;
+      oss << *nfa;         // operator<< writes FABuilder's syntax
+      const string text = oss.str();
+      delete nfa;
+      printMeasurement("FABuilder+buildNFA", params(n),
+        measure([&] { delete FABuilder(text.c_str()).buildNFA(); }));
+    } // for
+  cout << endl;
+
+  // allocations and memory of transformations and builders, of the
+  //   calling thread only (see AllocScope), so all with one thread
+  if (selected("Memory") && !allocationCounting())
+    cout << "Memory: needs ALLOC_COUNTING (see AllocTracker.h)" << endl;
+  else if (selected("Memory")) {
+    for (int n: {8, 64}) {
+      FAGenerator gen;
+      gen.setNrOfStates(n);
+      const string rText   = gen.nfaText();
+      const string gText   = gen.grammarText();
+      const string nfaText = FAGenerator::nthFromEndText(n < 10 ? n : 10);
+      reportAllocations("Memory: FABuilder::buildNFA", params(n),
+        [&] { return FABuilder(rText.c_str()).buildNFA(); });
+      reportAllocations("Memory: GrammarBuilder", params(n),
+        [&] { return GrammarBuilder(gText.c_str()).buildGrammar(); });
+      NFA *nfa = FABuilder(nfaText.c_str()).buildNFA();
+      DFA *dfa = nfa->dfaOf();
+      reportAllocations("Memory: NFA::dfaOf", params(n < 10 ? n : 10),
+        [&] { return nfa->dfaOf(); });
+      if (n <= 8)          // O(|S|^2) table
+        reportAllocations("Memory: DFA::minimalOf", params(n),
+          [&] { return dfa->minimalOf(); });
+      if (n <= 8) {        // pipeline with intermediate automata vs. fused
+        reportAllocations("Memory: dfaOf+minimalOf+renamedOf", params(n),
+          [&] {
+            DFA *d = nfa->dfaOf();
+            DFA *m = d->minimalOf();
+            delete d;
+            DFA *r = m->renamedOf();
+            delete m;
+            return r;
+          });
+        reportAllocations("Memory: NFA::renamedMinimalDfaOf", params(n),
+          [&] { return nfa->renamedMinimalDfaOf(true, 1); });
+      } // if
+      delete dfa;
+      delete nfa;
+    } // for
+    cout << endl;
+  } // if
+
+  // allocations for temporaries in transformations
+  if (selected("Arena")) {
+    NFA *nfa = nthFromEndNFA(8);
+    DFA *dfa = nfa->dfaOf();
+    reportArenaAllocations("Arena: NFA::dfaOf",     [&] { return nfa->dfaOf();     });
+    reportArenaAllocations("Arena: DFA::minimalOf", [&] { return dfa->minimalOf(); });
+    reportArenaAllocations("Arena: DFA::renamedOf", [&] { return dfa->renamedOf(); });
+    delete dfa;
+    delete nfa;
+    cout << endl;
+  } // if
+} // runBenchmarks
+
+
+// end of Benchmark.cpp
+//======================================================================
@@ -0,0 +1,66 @@
+// Benchmark.h:                                                HDO, 2021
+// -----------
+// In-tree benchmark harness and suite for the finite automata classes:
+// * measure(f) calls f repeatedly until a minimal run time is reached
+//   and returns the average time and number of allocations per call
+//   plus hardware counters (see PerfCounters.h) if available,
+// * printMeasurement prints one line of results (including ns/symbol
+//   and throughput for acceptance tests) and
+// * runBenchmarks runs the whole suite, started via
+//     ue03 -bench [filter]
+//   where only benchmarks with filter in their name are run.
+// Results depend on the build configuration, so compare builds with
+// and without NO_OBJECT_COUNTING (see ObjectCounter.h).
+//======================================================================
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <chrono>
+#include <string>
+
+#include "AllocTracker.h"
+#include "PerfCounters.h"
+
+
+struct Measurement {
+  long   calls;            // number of measured calls
+  double nsPerCall;        // average run time per call
+  double allocsPerCall;    // average number of allocations per call
+  PerfSample counters;     // sums over all calls, if counters.valid
+}; // Measurement
+
+template<typename Func>
+Measurement measure(Func f, double minSeconds = 0.1) {
+  f();                     // warm up (caches, lazy initializations)
+  Measurement  m = {0, 0.0, 0.0, {false, 0, 0, 0, 0}};
+  PerfCounters pc;         // opened outside of the measured region
+  long   allocs = allocationCount();
+  double ns;
+  auto start = std::chrono::steady_clock::now();
+  pc.start();
+  do {
+    f();
+    m.calls++;
+    ns = std::chrono::duration<double, std::nano>(
+           std::chrono::steady_clock::now() - start).count();
+  } while (ns < minSeconds * 1e9);
+  m.counters = pc.stop();  // includes the (few) instr. of the loop itself
+  m.nsPerCall     = ns / m.calls;
+  m.allocsPerCall = (double)(allocationCount() - allocs) / m.calls;
+  return m;
+} // measure
+
+void printMeasurement(const std::string &name, const std::string &params,
+                      const Measurement &m,
+                      long symbolsPerCall = 0); // 0: no acceptance test
+                      // counters per symbol for acceptance tests else per call
+
+
+void runBenchmarks(const std::string &filter = "");
+
+
+#endif
+
+// end of Benchmark.h
+//======================================================================
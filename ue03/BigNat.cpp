@@ -0,0 +1,73 @@
+// BigNat.cpp:                                                  HDO, 2021
+// ----------
+// Objects of class BigNat represent arbitrarily large natural numbers.
+//======================================================================
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "BigNat.h"
+
+
+BigNat::BigNat(uint64_t v) {
+  while (v != 0) {
+    limbs.push_back((uint32_t)v);
+    v >>= 32;
+  } // while
+} // BigNat::BigNat
+
+
+BigNat &BigNat::operator+=(const BigNat &b) {
+  if (limbs.size() < b.limbs.size())
+    limbs.resize(b.limbs.size(), 0);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < limbs.size(); i++) {
+    uint64_t sum = (uint64_t)limbs[i] + carry +
+                   (i < b.limbs.size() ? b.limbs[i] : 0);
+    limbs[i] = (uint32_t)sum;
+    carry    = sum >> 32;
+    if (carry == 0 && i >= b.limbs.size())
+      break;               // nothing left to add
+  } // for
+  if (carry != 0)
+    limbs.push_back((uint32_t)carry);
+  return *this;
+} // BigNat::operator+=
+
+
+string BigNat::toString() const {
+  if (isZero())
+    return "0";
+  vector<uint32_t> rest = limbs;
+  string digits;           // least significant first
+  while (!rest.empty()) {  // divide rest by 10^9, collect the remainders
+    uint64_t r = 0;
+    for (size_t i = rest.size(); i-- > 0; ) {
+      uint64_t cur = (r << 32) | rest[i];
+      rest[i] = (uint32_t)(cur / 1000000000);
+      r       = cur % 1000000000;
+    } // for
+    while (!rest.empty() && rest.back() == 0)
+      rest.pop_back();
+    for (int k = 0; k < 9 && (r != 0 || !rest.empty()); k++) {
+      digits.push_back((char)('0' + r % 10));
+      r /= 10;
+    } // for
+  } // while
+  reverse(digits.begin(), digits.end());
+  return digits;
+} // BigNat::toString
+
+
+ostream &operator<<(ostream &os, const BigNat &bn) {
+  os << bn.toString();
+  return os;
+} // operator<<
+
+
+// end of BigNat.cpp
+//======================================================================
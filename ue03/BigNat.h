@@ -0,0 +1,51 @@
+// BigNat.h:                                                    HDO, 2021
+// --------
+// Objects of class BigNat represent arbitrarily large natural numbers,
+// e.g., for the exact number of tapes accepted by an automaton, with
+// addition and decimal output only.
+//======================================================================
+
+#ifndef BigNat_h
+#define BigNat_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+class BigNat final { // no public base class, no object counting as there
+                     //   are many of them in counting algorithms
+  private:
+
+    std::vector<uint32_t> limbs; // base 2^32, least significant first,
+                                 //   no leading zero limbs, empty for 0
+  public:
+
+    BigNat(uint64_t v = 0);
+
+    BigNat &operator+=(const BigNat &b);
+
+    bool isZero() const {
+      return limbs.empty();
+    } // isZero
+
+    bool operator==(const BigNat &b) const {
+      return limbs == b.limbs;
+    } // operator==
+
+    bool operator!=(const BigNat &b) const {
+      return limbs != b.limbs;
+    } // operator!=
+
+    std::string toString() const; // decimal
+
+}; // BigNat
+
+std::ostream &operator<<(std::ostream &os, const BigNat &bn);
+
+
+#endif
+
+// end of BigNat.h
+//======================================================================
@@ -6,18 +6,28 @@
 #include <cmath>
 #include <cstring>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <map>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
 
+#include "Arena.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
+#include "TableStuff.h"
 #include "MbMatrix.h"
 #include "DFA.h"
+#include "NFA.h"
 #include "FABuilder.h"
+#include "AllocTracker.h"
+#include "Timer.h"
 
 
 typedef MbMatrix<State, State, bool> NeTable; // non-equivalent table
@@ -47,7 +57,11 @@ static void printNeTable(const StateSet &S, const NeTable &ne) {
 DFA::DFA(const StateSet &S,  const TapeSymbolSet &V,
          const State    &s1, const StateSet      &F,
          const DDelta   &delta)
-: FA(S, V, s1, F), delta(delta) {
+: FA(S, V, s1, F), delta(delta),
+  sIdx(this->S), vIdx(this->V), table(sIdx, vIdx, this->delta),
+  isFinal(sIdx.size(), false), start(sIdx.idOf(this->s1)) {
+  for (const State &f: this->F)
+    isFinal[sIdx.idOf(f)] = true;
 } // DFA::DFA
 
 
@@ -59,25 +73,18 @@ StateSet DFA::deltaAt(const State &src, TapeSymbol tSy) const {
     return StateSet();     // empty set of states = undefined
 } // DFA::deltaAt
 
-
-void DFA::onStateEntered(State s) const {
-   // do nothing
-}
+void DFA::appendTransitionsOf(StateId src,
+    vector<pair<TapeSymbol, StateId>> &transitions) const {
+  for (int a = 0; a < vIdx.size(); a++) {
+    StateId dest = table.destAt(src, a);
+    if (dest != undefId)
+      transitions.emplace_back(vIdx.symbolAt(a), dest);
+  } // for
+} // DFA::appendTransitionsOf
 
 
 bool DFA::accepts(const Tape &tape) const {
-  int        i   = 0;       // index of first symbol
-  TapeSymbol tSy = tape[i]; // fetch first tape symbol
-  State      s   = s1;      // start state
-  while (tSy != eot) {      // eot = end of tape
-    s = delta[s][tSy];
-    if (!defined(s))
-      return false;         // s undefined, so no acceptance
-    onStateEntered(s);
-    i++;
-    tSy = tape[i];          // fetch next symbol
-  } // while
-  return F.contains(s);     // accepted <==> s element of F
+  return run(tape, DFAObserver());
 } // DFA::accepts
 
 
@@ -85,8 +92,11 @@ bool DFA::accepts(const Tape &tape) const {
 // ------------------      Hopcroft/Motwani/Ullmann, p. 171):
 
 DFA *DFA::minimalOf() const {
+  TIME_PHASE("DFA::minimalOf");
+  TRACK_ALLOCATIONS("DFA::minimalOf");
 
-  NeTable ne; // table to define non-equivalent states
+  Arena   arena; // for all temporary data, released at once at the end
+  NeTable ne(arena.resource()); // table to define non-equivalent states
 
   // 1.  "table filling algorithm"
   // 1.a initialize ne table with false
@@ -102,6 +112,7 @@ DFA *DFA::minimalOf() const {
   bool anyChange = true;
   while (anyChange) {
     anyChange = false;
+    FA_STAT(statistics.refinementPasses++);
     for (const State &si: S)
       for (const State &sj: S)
           if ( (si != sj) && !ne[si][sj]) // si, sj seem to be equivalent
@@ -120,9 +131,10 @@ DFA *DFA::minimalOf() const {
   // printNeTable(S, ne);     // for debugging only
 
   // 2. from ne table create the partition of S (set of subsets)
-  SetOfStateSets partition;
+  SetOfStateSets partition(arena.resource());
   for (const State &si: S) {
-    StateSet subset = StateSet(si);
+    StateSet subset(arena.resource());
+    subset.insert(si);
     for (const State &sj: S)
       if ( (    si != sj  ) &&
            (!ne[si]  [sj]) )  // si and sj are equiv.
@@ -131,7 +143,7 @@ DFA *DFA::minimalOf() const {
   } // for
   // cout << "partition = " << partition << endl;
 
-  FABuilder fab; // builder for the minimal DFA
+  FABuilder fab(arena.resource()); // builder for the minimal DFA
 
   // 3. compute transitions for minimal DFA in builder
   for (const StateSet &srcStateSet: partition) {
@@ -165,13 +177,510 @@ DFA *DFA::minimalOf() const {
 } // DFA::minimalOf
 
 
+// DFA::minimalOfParallel: Moore-style partition refinement
+// ----------------------
+// on the integer table of the DFA (see refinedPartitionOf), results
+// in the same partition as the table filling algorithm in minimalOf
+
+DFA *DFA::minimalOfParallel(int nThreads) const {
+  TIME_PHASE("DFA::minimalOfParallel");
+  TRACK_ALLOCATIONS("DFA::minimalOfParallel");
+
+  const int n = sIdx.size(); // integer tables of this DFA
+  const int m = vIdx.size();
+  const Partition p = refinedPartitionOf(table, isFinal, nThreads);
+  FA_STAT(statistics.refinementPasses += p.nPasses);
+
+  // build minimal DFA from partition, states named like in minimalOf
+  vector<StateSet> subsets(p.nBlocks);
+  vector<StateId>  representative(p.nBlocks, undefId);
+  for (StateId s = 0; s < n; s++) { // in the order of S, so hint is O(1)
+    int b = p.blockOf[s];
+    subsets[b].insert(subsets[b].end(), sIdx.stateAt(s));
+    if (representative[b] == undefId)
+      representative[b] = s;
+  } // for
+  vector<State> names(p.nBlocks);
+  for (int b = 0; b < p.nBlocks; b++)
+    names[b] = subsets[b].stateOf();
+  // built directly as FABuilder does not allow the language {}
+  StateSet S, F;
+  DDelta   delta;
+  for (int b = 0; b < p.nBlocks; b++) {
+    S.insert(names[b]);
+    for (int a = 0; a < m; a++) {
+      StateId dest = table.destAt(representative[b], a);
+      if (dest != undefId)
+        delta[names[b]][vIdx.symbolAt(a)] = names[p.blockOf[dest]];
+    } // for
+  } // for
+  for (const State &f: this->F)
+    F.insert(names[p.blockOf[sIdx.idOf(f)]]);
+  return new DFA(S, V, names[p.blockOf[start]], F, delta);
+} // DFA::minimalOfParallel
+
+
+// Boolean Operations via Product Construction
+// --------------------------------------------
+
+DFA *DFA::productOf(const DFA &a, const DFA &b,
+                    bool (*accepting)(bool inA, bool inB), bool minimize) {
+  TIME_PHASE("DFA::productOf");
+  TRACK_ALLOCATIONS("DFA::productOf");
+
+  // 1. columns of a and b for the symbols of the union alphabet,
+  //    dead states of a and b are nA and nB
+  TapeSymbolSet V = a.V;
+  V.insert(b.V.begin(), b.V.end());
+  const SymbolIndex vIdx(V);
+  const int m  = vIdx.size();
+  const int nA = a.sIdx.size(), nB = b.sIdx.size();
+  vector<int> colA(m), colB(m);
+  for (int c = 0; c < m; c++) {
+    colA[c] = a.vIdx.indexOf(vIdx.symbolAt(c));
+    colB[c] = b.vIdx.indexOf(vIdx.symbolAt(c));
+  } // for
+  auto destA = [&](StateId p, int c) {
+    StateId d = (p == nA || colA[c] < 0) ? undefId : a.table.destAt(p, colA[c]);
+    return d == undefId ? nA : d;
+  }; // destA
+  auto destB = [&](StateId q, int c) {
+    StateId d = (q == nB || colB[c] < 0) ? undefId : b.table.destAt(q, colB[c]);
+    return d == undefId ? nB : d;
+  }; // destB
+  auto finalA = [&](StateId p) { return p < nA && a.isFinal[p]; };
+  auto finalB = [&](StateId q) { return q < nB && b.isFinal[q]; };
+  // pairs with a dead component that can never be final are not explored
+  const bool deadAHopeless = !accepting(false, false) && !accepting(false, true);
+  const bool deadBHopeless = !accepting(false, false) && !accepting(true, false);
+  const bool deadsHopeless = !accepting(false, false);
+
+  // 2. BFS over the reachable pairs, ids of pairs in dense or hash table
+  const long long nPairs = (long long)(nA + 1) * (nB + 1);
+  const bool      dense  = nPairs <= (1LL << 24);
+  vector<int> denseId(dense ? nPairs : 0, undefId);
+  unordered_map<long long, int> hashId;
+  vector<pair<StateId, StateId>> pairs;
+  vector<StateId> dests;  // product table, row by row
+  vector<char>    isFinal;
+  auto idOf = [&](StateId p, StateId q) -> int {
+    if ((p == nA && deadAHopeless) || (q == nB && deadBHopeless) ||
+        (p == nA && q == nB && deadsHopeless))
+      return undefId;
+    long long key = (long long)p * (nB + 1) + q;
+    int &id = dense ? denseId[key] : hashId.emplace(key, undefId).first->second;
+    if (id == undefId) {
+      id = (int)pairs.size();
+      pairs.emplace_back(p, q);
+      isFinal.push_back(accepting(finalA(p), finalB(q)));
+    } // if
+    return id;
+  }; // idOf
+  const StateId start = idOf(a.start, b.start); // never hopeless
+  for (size_t i = 0; i < pairs.size(); i++) {
+    const StateId p = pairs[i].first, q = pairs[i].second;
+    for (int c = 0; c < m; c++)
+      dests.push_back(idOf(destA(p, c), destB(q, c)));
+  } // for
+  return numberedDfaOf(DTable(m, move(dests)), isFinal, start, V, minimize);
+} // DFA::productOf
+
+
+DFA *DFA::numberedDfaOf(const DTable &table, const vector<char> &isFinal,
+                        StateId start, const TapeSymbolSet &V,
+                        bool minimize) {
+  const int n = table.nrOfStates();
+  const int m = table.nrOfSymbols();
+  const SymbolIndex vIdx(V);
+
+  // 1. trim: keep states from which a final state is reachable
+  vector<vector<StateId>> preds(n);
+  vector<StateId> stack;
+  vector<char>    productive(n, false);
+  for (StateId s = 0; s < n; s++) {
+    for (int c = 0; c < m; c++)
+      if (table.destAt(s, c) != undefId)
+        preds[table.destAt(s, c)].push_back(s);
+    if (isFinal[s]) {
+      productive[s] = true;
+      stack.push_back(s);
+    } // if
+  } // for
+  while (!stack.empty()) {
+    StateId s = stack.back();
+    stack.pop_back();
+    for (StateId p: preds[s])
+      if (!productive[p]) {
+        productive[p] = true;
+        stack.push_back(p);
+      } // if
+  } // while
+  vector<vector<StateId>>().swap(preds);
+  auto destAt = [&](StateId s, int c) {
+    StateId d = table.destAt(s, c);
+    return (d != undefId && productive[d]) ? d : undefId;
+  }; // destAt
+
+  // 2. blocks of equivalent states (one per state if not minimized)
+  Partition p;
+  if (minimize) {
+    vector<StateId> trimmed((size_t)n * m);
+    for (StateId s = 0; s < n; s++)
+      for (int c = 0; c < m; c++)
+        trimmed[(size_t)s * m + c] = destAt(s, c);
+    p = refinedPartitionOf(DTable(m, move(trimmed)), isFinal, 0);
+  } else {
+    p.blockOf.resize(n);
+    for (StateId s = 0; s < n; s++)
+      p.blockOf[s] = s;
+    p.nBlocks = n;
+    p.nPasses = 0;
+  } // else
+
+  // 3. number the blocks reachable from start in BFS order
+  vector<StateId> representative(p.nBlocks, undefId);
+  for (StateId s = n - 1; s >= 0; s--)
+    representative[p.blockOf[s]] = s;
+  vector<int> order, number(p.nBlocks, -1);
+  order.push_back(p.blockOf[start]);
+  number[p.blockOf[start]] = 0;
+  for (size_t i = 0; i < order.size(); i++)
+    for (int c = 0; c < m; c++) {
+      StateId dest = destAt(representative[order[i]], c);
+      if (dest != undefId && number[p.blockOf[dest]] < 0) {
+        number[p.blockOf[dest]] = (int)order.size();
+        order.push_back(p.blockOf[dest]);
+      } // if
+    } // for
+
+  // 4. build DFA directly (FABuilder does not allow empty languages)
+  int digits = (int)round(log(order.size()) / log(10) + 0.5);
+  vector<State> names(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    string nn = to_string(i);
+    names[i] = string(digits - nn.length(), '0') + nn;
+  } // for
+  StateSet S, F;
+  DDelta   delta;
+  for (size_t i = 0; i < order.size(); i++) {
+    StateId rep = representative[order[i]];
+    S.insert(S.end(), names[i]); // names are sorted, so O(1)
+    if (isFinal[rep])
+      F.insert(F.end(), names[i]);
+    for (int c = 0; c < m; c++) {
+      StateId dest = destAt(rep, c);
+      if (dest != undefId)
+        delta[names[i]][vIdx.symbolAt(c)] = names[number[p.blockOf[dest]]];
+    } // for
+  } // for
+  return new DFA(S, V, names[0], F, delta);
+} // DFA::numberedDfaOf
+
+
+DFA *DFA::intersect(const DFA &other, bool minimize) const {
+  return productOf(*this, other,
+                   [](bool inA, bool inB) { return inA && inB; }, minimize);
+} // DFA::intersect
+
+DFA *DFA::unite(const DFA &other, bool minimize) const {
+  return productOf(*this, other,
+                   [](bool inA, bool inB) { return inA || inB; }, minimize);
+} // DFA::unite
+
+DFA *DFA::minus(const DFA &other, bool minimize) const {
+  return productOf(*this, other,
+                   [](bool inA, bool inB) { return inA && !inB; }, minimize);
+} // DFA::minus
+
+DFA *DFA::complement(bool minimize) const {
+  TIME_PHASE("DFA::complement");
+  TRACK_ALLOCATIONS("DFA::complement");
+  // completion with dead state n (for all undefined transitions), then
+  //   the final states are flipped, unary, so without pairs as in productOf
+  const int n = sIdx.size(), m = vIdx.size();
+  vector<StateId> dests((size_t)(n + 1) * m, n);
+  for (StateId s = 0; s < n; s++)
+    for (int c = 0; c < m; c++) {
+      StateId d = table.destAt(s, c);
+      if (d != undefId)
+        dests[(size_t)s * m + c] = d;
+    } // for
+  vector<char> isFinalC(n + 1, true); // dead state is final in complement
+  for (StateId s = 0; s < n; s++)
+    isFinalC[s] = !isFinal[s];
+  return numberedDfaOf(DTable(m, move(dests)), isFinalC, start, V, minimize);
+} // DFA::complement
+
+
+// Language Equivalence (Hopcroft/Karp)
+// --------------------
+
+bool equivalent(const DFA &a, const DFA &b, Tape *counterexample) {
+  TIME_PHASE("equivalent");
+
+  // states of a: 0 .. nA (dead), states of b: nA + 1 .. nA + nB + 1 (dead)
+  TapeSymbolSet V = a.V;
+  V.insert(b.V.begin(), b.V.end());
+  const SymbolIndex vIdx(V);
+  const int nA = a.sIdx.size(), nB = b.sIdx.size();
+  auto destOf = [&](int s, TapeSymbol tSy) {
+    if (s <= nA) {
+      int c = a.vIdx.indexOf(tSy);
+      StateId d = (s == nA || c < 0) ? undefId : a.table.destAt(s, c);
+      return d == undefId ? nA : d;
+    } else {
+      int c = b.vIdx.indexOf(tSy), q = s - nA - 1;
+      StateId d = (q == nB || c < 0) ? undefId : b.table.destAt(q, c);
+      return nA + 1 + (d == undefId ? nB : d);
+    } // else
+  }; // destOf
+  auto isFinal = [&](int s) {
+    return s <= nA ? s < nA && a.isFinal[s]
+                   : s - nA - 1 < nB && b.isFinal[s - nA - 1];
+  }; // isFinal
+
+  vector<int> parent(nA + nB + 2);  // union-find with path halving
+  for (size_t i = 0; i < parent.size(); i++)
+    parent[i] = (int)i;
+  auto find = [&parent](int s) {
+    while (parent[s] != s)
+      s = parent[s] = parent[parent[s]];
+    return s;
+  }; // find
+
+  struct Pair { int p, q, from; TapeSymbol tSy; }; // from: index of pred.
+  vector<Pair> pairs;     // used as queue, kept for counterexamples
+  pairs.push_back({a.start, nA + 1 + b.start, -1, eot});
+  parent[find(a.start)] = find(nA + 1 + b.start);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    const Pair pq = pairs[i];
+    if (isFinal(pq.p) != isFinal(pq.q)) {
+      if (counterexample != nullptr) {
+        Tape tape;
+        for (int j = (int)i; pairs[j].from >= 0; j = pairs[j].from)
+          tape.push_back(pairs[j].tSy);
+        counterexample->assign(tape.rbegin(), tape.rend());
+      } // if
+      return false;
+    } // if
+    for (int c = 0; c < vIdx.size(); c++) {
+      TapeSymbol tSy = vIdx.symbolAt(c);
+      int p = destOf(pq.p, tSy), q = destOf(pq.q, tSy);
+      int rp = find(p), rq = find(q);
+      if (rp != rq) {
+        parent[rp] = rq;
+        pairs.push_back({p, q, (int)i, tSy});
+      } // if
+    } // for
+  } // for
+  return true;
+} // equivalent
+
+
+// Counting and Enumeration of Accepted Tapes
+// ------------------------------------------
+
+// w[k] for k = 0 .. n (see countsUpTo) for start state, add(a, b): a += b
+template<typename T, typename Add>
+static vector<T> countsOf(const DTable &table, const vector<char> &isFinal,
+                          StateId start, int n, int nThreads, Add add) {
+  if (nThreads <= 0)
+    nThreads = max(1, (int)thread::hardware_concurrency());
+  const int nStates = table.nrOfStates();
+  const int m       = table.nrOfSymbols();
+  if ((long long)nStates * m < (1LL << 14))
+    nThreads = 1;          // threads per step are too expensive
+  vector<T> cur(nStates), next(nStates), counts;
+  for (StateId s = 0; s < nStates; s++)
+    cur[s] = T(isFinal[s] ? 1 : 0);
+  counts.reserve(n + 1);
+  for (int k = 0; k <= n; k++) {
+    counts.push_back(cur[start]);
+    if (k == n)
+      break;
+    parallelFor(nStates, nThreads, [&](int from, int to) {
+      for (StateId s = from; s < to; s++) {
+        T   &sum   = next[s]; // assignment reuses its memory
+        bool first = true;
+        for (int a = 0; a < m; a++) {
+          StateId dest = table.destAt(s, a);
+          if (dest == undefId)
+            continue;
+          if (first)
+            sum = cur[dest];
+          else
+            add(sum, cur[dest]);
+          first = false;
+        } // for
+        if (first)
+          sum = T(0);
+      } // for
+    }); // parallelFor
+    cur.swap(next);
+  } // for
+  return counts;
+} // countsOf
+
+static uint64_t addMod(uint64_t a, uint64_t b, uint64_t p) { // a, b < p
+  return a >= p - b ? a - (p - b) : a + b;
+} // addMod
+
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t p) { // a, b < p
+#ifdef __SIZEOF_INT128__
+  return (uint64_t)((unsigned __int128)a * b % p);
+#else
+  uint64_t r = 0;          // double and add
+  for ( ; b != 0; b >>= 1) {
+    if (b & 1)
+      r = addMod(r, a, p);
+    a = addMod(a, a, p);
+  } // for
+  return r;
+#endif
+} // mulMod
+
+vector<BigNat> DFA::countsUpTo(int n, int nThreads) const {
+  TIME_PHASE("DFA::countsUpTo");
+  return countsOf<BigNat>(table, isFinal, start, n, nThreads,
+    [](BigNat &a, const BigNat &b) { a += b; });
+} // DFA::countsUpTo
+
+vector<uint64_t> DFA::countsModuloUpTo(int n, uint64_t p, int nThreads) const {
+  TIME_PHASE("DFA::countsModuloUpTo");
+  if (p == 0)
+    throw invalid_argument("modulus must not be 0");
+  vector<uint64_t> counts = countsOf<uint64_t>(table, isFinal, start, n,
+    nThreads, [p](uint64_t &a, uint64_t b) { a = addMod(a, b, p); });
+  for (uint64_t &c: counts)
+    c %= p;                // w[0] is 1 even for p == 1
+  return counts;
+} // DFA::countsModuloUpTo
+
+uint64_t DFA::countModulo(uint64_t n, uint64_t p, int nThreads) const {
+  TIME_PHASE("DFA::countModulo");
+  if (p == 0)
+    throw invalid_argument("modulus must not be 0");
+  if (nThreads <= 0)
+    nThreads = max(1, (int)thread::hardware_concurrency());
+  const int k = sIdx.size(), m = vIdx.size();
+  typedef vector<uint64_t> Matrix; // k x k, row by row
+  Matrix mp(k * k, 0);     // M^(2^i), M[s][d]: nr. of symbols s -> d
+  for (StateId s = 0; s < k; s++)
+    for (int a = 0; a < m; a++)
+      if (table.destAt(s, a) != undefId)
+        mp[s * k + table.destAt(s, a)] =
+          addMod(mp[s * k + table.destAt(s, a)], 1 % p, p);
+  vector<uint64_t> x(k);   // M^(bits of n so far) * f
+  for (StateId s = 0; s < k; s++)
+    x[s] = isFinal[s] ? 1 % p : 0;
+  const int threads = (long long)k * k * k < (1LL << 18) ? 1 : nThreads;
+  while (n != 0) {
+    if (n & 1) {
+      vector<uint64_t> y(k, 0);
+      for (StateId s = 0; s < k; s++)
+        for (StateId d = 0; d < k; d++)
+          if (mp[s * k + d] != 0)
+            y[s] = addMod(y[s], mulMod(mp[s * k + d], x[d], p), p);
+      x.swap(y);
+    } // if
+    n >>= 1;
+    if (n == 0)
+      break;
+    Matrix sq(k * k, 0);   // mp * mp, rows in parallel
+    parallelFor(k, threads, [&](int from, int to) {
+      for (StateId s = from; s < to; s++)
+        for (StateId j = 0; j < k; j++) {
+          uint64_t msj = mp[s * k + j];
+          if (msj != 0)
+            for (StateId d = 0; d < k; d++)
+              sq[s * k + d] = addMod(sq[s * k + d],
+                                     mulMod(msj, mp[j * k + d], p), p);
+        } // for
+    }); // parallelFor
+    mp.swap(sq);
+  } // while
+  return x[start];
+} // DFA::countModulo
+
+
+// --- implementation of class DFA::TapeEnumerator ---
+
+DFA::TapeEnumerator::TapeEnumerator(const DFA &dfa, int maxLen)
+: dfa(dfa), maxLen(maxLen), live(maxLen < 0 ? 0 : maxLen + 1),
+  len(0), lenStarted(false) {
+  const int n = dfa.sIdx.size(), m = dfa.vIdx.size();
+  for (int k = 0; k <= maxLen; k++) {
+    live[k].assign(n, false);
+    for (StateId s = 0; s < n; s++)
+      if (k == 0)
+        live[k][s] = dfa.isFinal[s];
+      else
+        for (int a = 0; a < m && !live[k][s]; a++) {
+          StateId dest = dfa.table.destAt(s, a);
+          live[k][s] = dest != undefId && live[k - 1][dest];
+        } // for
+  } // for
+} // DFA::TapeEnumerator::TapeEnumerator
+
+bool DFA::TapeEnumerator::next(Tape &tape) {
+  const int m = dfa.vIdx.size();
+  while (len <= maxLen) {
+    if (!lenStarted) {
+      lenStarted = true;
+      if (live[len][dfa.start])
+        path.push_back(make_pair(dfa.start, 0));
+    } // if
+    if (path.empty()) {    // all tapes of length len enumerated
+      len++;
+      lenStarted = false;
+      continue;
+    } // if
+    const int depth = (int)path.size() - 1; // == this->tape.length()
+    if (depth == len) {    // accepted as live[0][state]
+      tape = this->tape;
+      path.pop_back();
+      if (!this->tape.empty())
+        this->tape.pop_back();
+      return true;
+    } // if
+    StateId s    = path.back().first;
+    StateId dest = undefId;
+    while (path.back().second < m && dest == undefId) {
+      int a = path.back().second++;
+      StateId d = dfa.table.destAt(s, a);
+      if (d != undefId && live[len - depth - 1][d]) {
+        dest = d;
+        this->tape.push_back(dfa.vIdx.symbolAt(a));
+      } // if
+    } // while
+    if (dest != undefId)
+      path.push_back(make_pair(dest, 0));
+    else {                 // no more continuations from s
+      path.pop_back();
+      if (!this->tape.empty())
+        this->tape.pop_back();
+    } // else
+  } // while
+  return false;
+} // DFA::TapeEnumerator::next
+
+
+NFA *DFA::reversed() const {
+  TIME_PHASE("DFA::reversed");
+  return reversedNFAOf(s1, F, nDeltaOf(delta), V);
+} // DFA::reversed
+
+
 DFA *DFA::renamedOf() const {
+  TIME_PHASE("DFA::renamedOf");
 
   // 1. rename states
 
+  Arena arena; // for all temporary data, released at once at the end
+
   vector<State>  tss = FA::topSortedStates();
   int digits = (int)round(log(tss.size()) / log(10) + 0.5);
-  map<State, State> newName; // map: old name -> new name ("0", "1", ...)
+  pmr::map<State, State> newName(arena.resource()); // old name -> new name
 
   for (size_t i = 0; i < tss.size(); i++) {
   string nn = to_string(i); // new name for tss[i]
@@ -182,7 +691,7 @@ DFA *DFA::renamedOf() const {
 
   // 2. build new automaton
 
-  FABuilder fab;
+  FABuilder fab(arena.resource());
 
   for (auto &t: delta.transitions())
     fab.addTransition(newName[t.src], t.tSy, newName[t.dest]);
@@ -6,19 +6,38 @@
 #ifndef DFA_h
 #define DFA_h
 
+#include <cstdint>
+#include <vector>
+
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
+#include "TableStuff.h"
+#include "BigNat.h"
 #include "FA.h"
 
 
 class FABuilder;           // forward for friend declaration only
+class NFA;                 // forward for transformation DFA -> NFA
+
+
+// observer for DFA::run: onTransition is called for each transition
+//   taken, with states and symbol in integer form (see TableStuff.h);
+//   it is empty here, so run(tape, DFAObserver()) has no hook at all,
+//   derived observers hide it and get inlined (no virtual dispatch)
+struct DFAObserver {
+  void onTransition(StateId /*src*/, int /*symIdx*/, StateId /*dest*/) {
+  } // onTransition
+}; // DFAObserver
 
 class DFA: public  FA
  /*OC+*/ , private ObjectCounter<DFA> /*+OC*/ {
 
   friend class FABuilder;  // so ::build... methods can call prot. constr.
 
+  friend bool equivalent(const DFA &a, const DFA &b, Tape *counterexample);
+  friend class NFA;        // for numberedDfaOf, see NFA::trivialDfaOf
+
   private:
 
     typedef FA Base;
@@ -31,27 +50,148 @@ class DFA: public  FA
         const DDelta   &delta);
 
     virtual StateSet deltaAt(const State &src, TapeSymbol tSy) const;
+    virtual void appendTransitionsOf(StateId src,
+      std::vector<std::pair<TapeSymbol, StateId>> &transitions) const;
+
+    // reachable product of a and b over the union of their alphabets,
+    //   undefined transitions lead to an implicit dead state, a pair is
+    //   final iff accepting(final in a, final in b), see intersect etc.
+    static DFA *productOf(const DFA &a, const DFA &b,
+                          bool (*accepting)(bool inA, bool inB),
+                          bool minimize);
+
+    // DFA from integer form: only states that can reach a final state
+    //   (and the start state), optionally minimized, named as by renamedOf
+    static DFA *numberedDfaOf(const DTable &table,
+                              const std::vector<char> &isFinal,
+                              StateId start, const TapeSymbolSet &V,
+                              bool minimize);
 
   public:
 
     const DDelta delta;    // deterministic transition function
 
+  protected:
+
+    // integer tables, computed once on construction (see TableStuff.h)
+    const StateIndex  sIdx;
+    const SymbolIndex vIdx;
+    const DTable      table;
+    std::vector<char> isFinal; // StateId -> final?
+    const StateId     start;
+
+  public:
+
     DFA(const DFA  &dfa) = default;
     DFA(      DFA &&dfa) = default;
 
     virtual ~DFA() = default;
 
-    virtual void onStateEntered(State s) const;
-
     virtual bool accepts(const Tape &tape) const; // impl. of abstr. meth.
 
+    virtual const StateIndex &stateIndex() const { // impl. of abstr. meth.
+      return sIdx;
+    } // stateIndex
+
+    // execution core of accepts (and of derived classes, e.g., Moore):
+    //   runs over tape calling observer.onTransition for each transition
+    //   taken, stops at undefined transitions and returns acceptance
+    template<typename Observer>
+    bool run(const Tape &tape, Observer &&observer) const;
+
     DFA *minimalOf() const; // minimization: DFA => minimal DFA
 
+    // same minimal DFA as minimalOf, but by Moore-style partition
+    //   refinement with nThreads threads (0: one per hardware thread)
+    DFA *minimalOfParallel(int nThreads = 0) const;
+
     DFA *renamedOf() const; // equiv. automation with states named 0, 1, ...
 
+    NFA *reversed() const;  // NFA for the reversed language, see NFA.h
+
+    // boolean operations on the languages, computed by a BFS over the
+    //   reachable pairs of states in integer form, the alphabet of the
+    //   result is the union of both alphabets, its states are named
+    //   0, 1, ... (as by renamedOf), with minimize == true it is minimal
+    DFA *intersect(const DFA &other, bool minimize = false) const;
+    DFA *unite    (const DFA &other, bool minimize = false) const;
+    DFA *minus    (const DFA &other, bool minimize = false) const;
+    DFA *complement(bool minimize = false) const; // V* - L(this)
+
+    // number of accepted tapes of each length 0 .. n (over V), exact or
+    //   modulo p, by DP over the integer table (w[k + 1][s] = sum of
+    //   w[k][dest] over the transitions of s, w[0][s] = s final?), for
+    //   large DFAs parallelized across states with nThreads threads
+    //   (0: one per hardware thread)
+    std::vector<BigNat>   countsUpTo(int n, int nThreads = 0) const;
+    std::vector<uint64_t> countsModuloUpTo(int n, uint64_t p,
+                                           int nThreads = 0) const;
+
+    // number of accepted tapes of length n modulo p, by repeated squaring
+    //   of the matrix of transition counts in O(|S|^3 log n)
+    uint64_t countModulo(uint64_t n, uint64_t p, int nThreads = 0) const;
+
+    class TapeEnumerator;  // accepted tapes in length-lex. order, see below
+
 }; // DFA
 
 
+// L(a) == L(b)? by Hopcroft-Karp: union-find on the states of both DFAs
+//   (plus a dead state each), starting with the start states, merging
+//   the successors of merged states, near-linear in |S| * |V|; if not
+//   equivalent and counterexample != nullptr, *counterexample is set to
+//   a tape accepted by exactly one of a and b
+bool equivalent(const DFA &a, const DFA &b, Tape *counterexample = nullptr);
+
+
+// Objects of class DFA::TapeEnumerator enumerate the tapes accepted by
+//   a DFA up to a maximal length lazily in length-lexicographic order
+//   (symbols in the order of V): depth-first for each length, only into
+//   states from which the rest of the length can be accepted, so each
+//   tape costs O(length * |V|). The DFA has to outlive the enumerator.
+
+class DFA::TapeEnumerator final // no public base class
+        /*OC+*/ : private ObjectCounter<DFA::TapeEnumerator> /*+OC*/ {
+
+  private:
+
+    const DFA &dfa;
+    const int  maxLen;
+    std::vector<std::vector<char>> live; // live[k][s]: a tape of length k
+                                         //   is accepted from s
+    int  len;              // length of the tapes enumerated now
+    bool lenStarted;
+    std::vector<std::pair<StateId, int>> path; // (state, next column)
+    Tape tape;             // symbols along path
+
+  public:
+
+    TapeEnumerator(const DFA &dfa, int maxLen);
+
+    // next accepted tape, false if there are no more up to maxLen
+    bool next(Tape &tape);
+
+}; // DFA::TapeEnumerator
+
+
+template<typename Observer>
+bool DFA::run(const Tape &tape, Observer &&observer) const {
+  StateId s = start;
+  for (const char *p = tape.c_str(); *p != eot; p++) { // eot = end of tape
+    int a = vIdx.indexOf(*p);
+    if (a < 0)
+      return false;         // tape symbol not in V, so no acceptance
+    StateId dest = table.destAt(s, a);
+    if (dest == undefId)
+      return false;         // dest undefined, so no acceptance
+    FA_STAT(statistics.transitionsFollowed++);
+    observer.onTransition(s, a, dest);
+    s = dest;
+  } // for
+  return isFinal[s];        // accepted <==> s element of F
+} // DFA::run
+
+
 #endif
 
 // end of DFA.h
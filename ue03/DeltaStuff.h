@@ -54,6 +54,19 @@ class Delta:               //   delta: State x TapeSymbol -> DestT
 
   public:
 
+    typedef typename Base::allocator_type allocator_type;
+
+    Delta() = default;
+    Delta(const Delta  &d) = default;
+    Delta(      Delta &&d) = default;
+
+    explicit Delta(const allocator_type &a) // e.g., for Deltas in an Arena
+    : Base(a) {
+    } // Delta
+
+    Delta &operator=(const Delta  &d) = default;
+    Delta &operator=(      Delta &&d) = default;
+
     vector<Transition<DestT>> transitions() const {
       vector<Transition<DestT>> v;
       for (auto &p1: *this)
@@ -7,19 +7,22 @@
 //======================================================================
 
 #include <algorithm>
+#include <deque>
 #include <iostream>
 #include <fstream>
-#include <map>
 #include <stdexcept>
 #include <set>
 #include <sstream>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "DeltaStuff.h"
+#include "TableStuff.h"
 #include "FA.h"
 #include "DFA.h"
 #include "NFA.h"
@@ -35,23 +38,219 @@ using namespace std;
 #define WRITE_TRANSITIONS_AS_TEXT         // #undef for programmatical init.
 
 
+vector<StateId> FA::bfsOrder() const {
+  const StateIndex &sIdx = stateIndex();
+  vector<char>    visited(sIdx.size(), false);
+  vector<StateId> order;   // also the queue: order[i ..] still to expand
+  vector<pair<TapeSymbol, StateId>> transitions;
+  order.reserve(sIdx.size());
+  StateId start = sIdx.idOf(s1);
+  visited[start] = true;
+  order.push_back(start);
+  for (size_t i = 0; i < order.size(); i++) {
+    transitions.clear();
+    appendTransitionsOf(order[i], transitions);
+    for (const auto &t: transitions)
+      if (!visited[t.second]) {
+        visited[t.second] = true;
+        order.push_back(t.second);
+      } // if
+  } // for
+  return order;
+} // FA::bfsOrder
+
 vector<State> FA::topSortedStates() const {
-  TapeSymbolSet VwithEps = V;
-  VwithEps.insert(eps);    // to respect epsilon transitions
+  const StateIndex &sIdx = stateIndex();
   vector<State> tss;       // topologically sorted states
-  tss.push_back(s1);       // start with start state s1
-  for (unsigned int i = 0; i < tss.size(); i++) {
-    State src = tss[i];    // copy State as tss.push_back may reallocate!!!
-    for (char tSy: VwithEps)
-      for (const State &dest: deltaAt(src, tSy))
-        if (find(tss.begin(), tss.end(), dest) ==
-            tss.end())     // dest is not in tss yet, so:
-          tss.push_back(dest);
-  } // for
+  for (StateId id: bfsOrder())
+    tss.push_back(sIdx.stateAt(id));
   return tss;
 } // topSortedStates
 
 
+// language queries:
+// ----------------
+
+FAGraph FA::graphOf() const {
+  const StateIndex &sIdx = stateIndex();
+  FAGraph graph(sIdx.size());
+  for (StateId src = 0; src < sIdx.size(); src++)
+    appendTransitionsOf(src, graph[src]);
+  return graph;
+} // FA::graphOf
+
+// shortest tape (eps. transitions do not count) leading from state from
+//   to a state with isTarget, via 0-1 BFS, false if there is none
+static bool shortestPathOf(const FAGraph &graph, StateId from,
+                           const vector<char> &isTarget, Tape &tape,
+                           StateId &reached) {
+  const int n = (int)graph.size();
+  vector<int>                       dist(n, -1);
+  vector<char>                      done(n, false);
+  vector<pair<StateId, TapeSymbol>> pred(n, make_pair(undefId, eot));
+  deque<StateId> queue;    // front: eps. transitions, back: others
+  dist[from] = 0;
+  queue.push_back(from);
+  while (!queue.empty()) {
+    StateId s = queue.front();
+    queue.pop_front();
+    if (done[s])
+      continue;
+    done[s] = true;
+    if (isTarget[s]) {
+      Tape path;           // backwards, pred[from] is never set
+      for (StateId t = s; t != from; t = pred[t].first)
+        if (pred[t].second != eps)
+          path.push_back(pred[t].second);
+      tape.assign(path.rbegin(), path.rend());
+      reached = s;
+      return true;
+    } // if
+    for (const auto &e: graph[s]) {
+      int d = dist[s] + (e.first == eps ? 0 : 1);
+      if (!done[e.second] && (dist[e.second] < 0 || d < dist[e.second])) {
+        dist[e.second] = d;
+        pred[e.second] = make_pair(s, e.first);
+        if (e.first == eps)
+          queue.push_front(e.second);
+        else
+          queue.push_back(e.second);
+      } // if
+    } // for
+  } // while
+  return false;
+} // shortestPathOf
+
+bool FA::isEmpty() const {
+  Tape witness;
+  return !shortestWitness(witness);
+} // FA::isEmpty
+
+bool FA::shortestWitness(Tape &witness) const {
+  const StateIndex &sIdx = stateIndex();
+  vector<char> isFinal(sIdx.size(), false);
+  for (const State &f: F)
+    isFinal[sIdx.idOf(f)] = true;
+  StateId reached;
+  return shortestPathOf(graphOf(), sIdx.idOf(s1), isFinal,
+                        witness, reached);
+} // FA::shortestWitness
+
+bool FA::isFinite() const {
+  Tape u, v, w;
+  return !pumpingWitness(u, v, w);
+} // FA::isFinite
+
+bool FA::pumpingWitness(Tape &u, Tape &v, Tape &w) const {
+  const StateIndex &sIdx = stateIndex();
+  const FAGraph    graph = graphOf();
+  const int        n     = sIdx.size();
+  vector<char> isFinal(n, false);
+  for (const State &f: F)
+    isFinal[sIdx.idOf(f)] = true;
+
+  // 1. trim: live states are reachable from s1 and reach a final state
+  vector<char> reachable(n, false), productive(n, false);
+  vector<vector<StateId>> preds(n);
+  vector<StateId> stack;
+  reachable[sIdx.idOf(s1)] = true;
+  stack.push_back(sIdx.idOf(s1));
+  while (!stack.empty()) {
+    StateId s = stack.back();
+    stack.pop_back();
+    for (const auto &e: graph[s])
+      if (!reachable[e.second]) {
+        reachable[e.second] = true;
+        stack.push_back(e.second);
+      } // if
+  } // while
+  for (StateId s = 0; s < n; s++) {
+    for (const auto &e: graph[s])
+      preds[e.second].push_back(s);
+    if (isFinal[s]) {
+      productive[s] = true;
+      stack.push_back(s);
+    } // if
+  } // for
+  while (!stack.empty()) {
+    StateId s = stack.back();
+    stack.pop_back();
+    for (StateId p: preds[s])
+      if (!productive[p]) {
+        productive[p] = true;
+        stack.push_back(p);
+      } // if
+  } // while
+  auto live = [&](StateId s) { return reachable[s] && productive[s]; };
+
+  // 2. SCCs of the live states (Tarjan, iterative), L is infinite iff
+  //    there is a non-eps. transition within an SCC
+  vector<int>  index(n, -1), low(n, 0), sccOf(n, -1);
+  vector<char> onStack(n, false);
+  vector<pair<StateId, size_t>> calls; // (state, index of next edge)
+  int nextIndex = 0, nSccs = 0;
+  for (StateId root = 0; root < n; root++) {
+    if (!live(root) || index[root] >= 0)
+      continue;
+    index[root] = low[root] = nextIndex++;
+    stack.push_back(root);
+    onStack[root] = true;
+    calls.push_back(make_pair(root, 0));
+    while (!calls.empty()) {
+      StateId x = calls.back().first;
+      if (calls.back().second < graph[x].size()) { // next edge x -> y
+        StateId y = graph[x][calls.back().second++].second;
+        if (!live(y))
+          continue;
+        if (index[y] < 0) {
+          index[y] = low[y] = nextIndex++;
+          stack.push_back(y);
+          onStack[y] = true;
+          calls.push_back(make_pair(y, 0));
+        } else if (onStack[y])
+          low[x] = min(low[x], index[y]);
+        continue;
+      } // if
+      calls.pop_back();    // "return" from x
+      if (!calls.empty())
+        low[calls.back().first] = min(low[calls.back().first], low[x]);
+      if (low[x] != index[x])
+        continue;          // x is not the root of an SCC
+      StateId y;
+      do {
+        y = stack.back();
+        stack.pop_back();
+        onStack[y] = false;
+        sccOf[y]   = nSccs;
+      } while (y != x);
+      nSccs++;
+    } // while
+  } // for
+
+  // 3. witness for a non-eps. transition x -tSy-> y within an SCC:
+  //    u leads from s1 to x, v = tSy + path from y to x, w from x to F
+  for (StateId x = 0; x < n; x++) {
+    if (!live(x))
+      continue;
+    for (const auto &e: graph[x]) {
+      if (e.first == eps || !live(e.second) || sccOf[e.second] != sccOf[x])
+        continue;
+      vector<char> isX(n, false);
+      isX[x] = true;
+      StateId reached;
+      Tape back;
+      shortestPathOf(graph, sIdx.idOf(s1), isX, u, reached);
+      if (e.second != x)
+        shortestPathOf(graph, e.second, isX, back, reached);
+      v = string(1, e.first) + back;
+      shortestPathOf(graph, x, isFinal, w, reached);
+      return true;
+    } // for
+  } // for
+  return false;
+} // FA::pumpingWitness
+
+
 // writeToGraphVizFile:
 // -------------------
 
@@ -69,99 +268,150 @@ static void writeTransition(ostream &ofs,
   else
     ofs << " [label = \"" << tSysStr  << "\"" <<
            " fontname = " << fontName;
-  ofs << " fontsize = " << fontSize << "]; " << endl;
+  ofs << " fontsize = " << fontSize << "]; " << '\n';
 } // writeTransition
 
-void FA::genGraphVizFile(const string &fileName,
-                         const string &name) const {
-  ofstream ofs(fileName);
-  if (!ofs.good())
-    throw runtime_error("error on opening output file \"" +
-                        fileName + "\"");
+// name of the node for all states beyond GraphVizOptions::maxStates
+static const string moreStatesNode = "...";
+
+void FA::writeGraphViz(ostream &os, const string &name,
+                       const GraphVizOptions &options) const {
+  const StateIndex &sIdx = stateIndex();
+  const int n = sIdx.size();
 
 #ifdef LIST_STATES_IN_TOPOLOGIC_ORDER
-  vector<State> Sordered = topSortedStates();
+  vector<StateId> Sordered = bfsOrder();
 #else                      // list states in lexicographic
-  vector<State> Sordered(this->S.begin(), this->S.end());
+  vector<StateId> Sordered(n);
+  for (StateId id = 0; id < n; id++)
+    Sordered[id] = id;
 #endif
-  TapeSymbolSet V = this->V; // copy to allow changes
-  if (typeid(*this) == typeid(NFA)) // // it's an NFA, so need for ...
-    V.insert(eps); // ... a trick to respect epsilon transitions
-
-  ofs << "digraph finite_state_machine {" << endl;
-  ofs << endl;
-  ofs << "  rankdir = LR;" << endl;
-  ofs << endl;
-  ofs << "  node [fontname = " << fontName <<
-                " fontsize = " << fontSize <<
-                " style = filled fillcolor = gray90]" << endl;
+  const bool limited = options.maxStates > 0 &&
+                       options.maxStates < (int)Sordered.size();
+  if (limited)
+    Sordered.resize(options.maxStates);
+  vector<char> shown(n, !limited); // all states if not limited
+  if (limited)
+    for (StateId id: Sordered)
+      shown[id] = true;
+  // undefId stands for all states beyond maxStates (see slotOf below)
+  auto nameOf = [&](StateId id) -> const State & {
+    return (id != undefId && shown[id]) ? sIdx.stateAt(id) : moreStatesNode;
+  }; // nameOf
+
+  os << "digraph finite_state_machine {" << '\n';
+  os << '\n';
+  os << "  rankdir = LR;" << '\n';
+  os << '\n';
+  os << "  node [fontname = " << fontName <<
+               " fontsize = " << fontSize <<
+               " style = filled fillcolor = gray90]" << '\n';
   // optional name of automaton
   if (name != "")
-    ofs << "  \"" << name << ":\" [shape = none style = \"\" " <<
-           "fontsize = " << (fontSize + 2) << "];" << endl;
+    os << "  \"" << name << ":\" [shape = none style = \"\" " <<
+          "fontsize = " << (fontSize + 2) << "];" << '\n';
   // shape for START node *->
-  ofs << "  node [shape = point]; START; // shape for START node" << endl;
+  os << "  node [shape = point]; START; // shape for START node" << '\n';
   // shape for final nodes
-  ofs << "  node [shape = " <<
-        (maxStateNameLen(F) <= 2 ? "circle" : "ellipse") <<
-         " peripheries = 2]";
+  os << "  node [shape = " <<
+       (maxStateNameLen(F) <= 2 ? "circle" : "ellipse") <<
+        " peripheries = 2]";
   for (const State &f: F)
-    ofs << " \"" << f << "\"";
-  ofs << "; // shape for final nodes" << endl;
+    if (shown[sIdx.idOf(f)])
+      os << " \"" << f << "\"";
+  os << "; // shape for final nodes" << '\n';
   // shape for non-final nodes
-  ofs << "  node [shape = " <<
-        (maxStateNameLen(S - F) <= 2 ? "circle" : "ellipse") <<
-         " peripheries = 1];  // shape for non-final nodes" << endl;
+  os << "  node [shape = " <<
+       (maxStateNameLen(S - F) <= 2 ? "circle" : "ellipse") <<
+        " peripheries = 1];  // shape for non-final nodes" << '\n';
+  if (limited)
+    os << "  \"" << moreStatesNode << "\" [shape = none style = \"\"]; " <<
+          "// " << (n - options.maxStates) << " more states" << '\n';
+  // optional clusters of states
+  if (options.clusterSize > 0)
+    for (size_t i = 0; i < Sordered.size(); i += options.clusterSize) {
+      os << "  subgraph cluster_" << (i / options.clusterSize) << " {";
+      for (size_t j = i; j < Sordered.size() &&
+                         j < i + options.clusterSize; j++)
+        os << " \"" << sIdx.stateAt(Sordered[j]) << "\"";
+      os << " }" << '\n';
+    } // for
   // finally all the transitions
-  ofs << "  START -> \"" << s1 << "\";" << endl;
-  ofs << endl;
+  os << "  START -> \"" << s1 << "\";" << '\n';
+  os << '\n';
+
+  vector<pair<TapeSymbol, StateId>> transitions; // of one src
+#ifdef COLLECT_TRANSITIONS_TO_ONE_ARROW
+  // per src: dest -> slot in labels, -1 if dest has no transition yet,
+  //   undefId is used for all states beyond maxStates
+  vector<int> slotOf(n + 1, -1);
+  struct Label {
+    StateId dest;
+    bool       hasEpsilonTransition;
+    TapeSymbol lastTSy;    // transitions come in ascending order of
+    string     tSysStr;    //   symbols, so duplicates (to "...") follow
+  }; // Label              //   each other, tSysStr without EPSILON
+  vector<Label> labels;
+#endif
+
+  for (StateId src: Sordered) {
+    transitions.clear();
+    appendTransitionsOf(src, transitions);
 
 #ifdef COLLECT_TRANSITIONS_TO_ONE_ARROW
 
-  //       (src,  dest) -> {tSy1, tSy2, ...}
-  map<pair<State, State>, TapeSymbolSet> collectedTransitions;
-  for (const State &src: S)
-    for (char tSy: V)
-      for (const State &dest: deltaAt(src, tSy))
-        collectedTransitions[make_pair(src, dest)].insert(tSy);
-  for (const State &src: Sordered)
-    for (const State &dest: S) {
-      auto it = collectedTransitions.find(make_pair(src, dest));
-      if (it != collectedTransitions.end()) {
-          string tSysStr;
-          bool hasEpsilonTransition = false;
-          bool first = true;
-          for (const auto &tSy: it->second) { // is a TapeSymbolSet
-            if (tSy == eps)
-              hasEpsilonTransition = true;
-            else {
-              if (!first)
-                tSysStr.append(", ");
-              tSysStr.append(stringOf(tSy)); // not EPSILON
-              first = false;
-            } // else
-          } // for
-          if (hasEpsilonTransition)
-            writeTransition(ofs, src, dest, stringOf(eps));
-          if (tSysStr != "")
-            writeTransition(ofs, src, dest, tSysStr);
+    labels.clear();
+    for (const auto &t: transitions) {
+      StateId dest = shown[t.second] ? t.second : undefId;
+      int &slot = slotOf[dest + 1];
+      if (slot < 0) {
+        slot = (int)labels.size();
+        labels.push_back(Label{dest, false, eps, ""});
       } // if
+      Label &l = labels[slot];
+      if (t.first == eps)
+        l.hasEpsilonTransition = true;
+      else if (t.first != l.lastTSy) {
+        if (l.tSysStr != "")
+          l.tSysStr.append(", ");
+        l.tSysStr.append(stringOf(t.first)); // not EPSILON
+        l.lastTSy = t.first;
+      } // else
+    } // for
+    sort(labels.begin(), labels.end(), // dest. states in order of S
+         [](const Label &l1, const Label &l2) { return l1.dest < l2.dest; });
+    for (const Label &l: labels) {
+      slotOf[l.dest + 1] = -1; // reset for next src
+      if (l.hasEpsilonTransition)
+        writeTransition(os, sIdx.stateAt(src), nameOf(l.dest),
+                        stringOf(eps));
+      if (l.tSysStr != "")
+        writeTransition(os, sIdx.stateAt(src), nameOf(l.dest), l.tSysStr);
     } // for
 
 #else // draw one arrow per transition
 
-  for (const State &src: Sordered)
-    for (char tSy: V)
-      for (const State &dest: deltaAt(src, tSy))
-        if (tSy == EPSILON)
-          writeTransition(ofs, src, dest, stringOf(EPSILON));
-        else
-          writeTransition(ofs, src, dest, stringOf(tSy));
+    for (const auto &t: transitions)
+      writeTransition(os, sIdx.stateAt(src), nameOf(t.second),
+                      stringOf(t.first));
 
 #endif // COLLECT_TRANSITIONS_TO_ONE_ARROW
+  } // for
 
-  ofs << endl;
-  ofs << "}" << endl;
+  os << '\n';
+  os << "}" << '\n';
+} // FA::writeGraphViz
+
+void FA::genGraphVizFile(const string &fileName, const string &name,
+                         const GraphVizOptions &options) const {
+  vector<char> buffer(1 << 16); // set before opening, so no flush per line
+  ofstream ofs;
+  ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+  ofs.open(fileName);
+  if (!ofs.good())
+    throw runtime_error("error on opening output file \"" +
+                        fileName + "\"");
+  writeGraphViz(ofs, name, options);
   ofs.close();
 } // FA::genGraphVizFile
 
@@ -11,12 +11,49 @@
 
 #include <iosfwd>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "DeltaStuff.h"
+#include "TableStuff.h"
+
+
+// FAStats: counters for the hot paths of acceptance tests and
+// transformations, collected only if DO_FA_STATS is defined (see FA_STAT),
+// otherwise FA::stats() returns all zeros and there are no costs at all
+struct FAStats {
+  long subsetStates        = 0; // DFA states created by NFA::dfaOf
+  long closureExpansions   = 0; // epsilon closures computed
+  long transitionsFollowed = 0; // (state, symbol) -> dest. steps taken
+  long maxLiveSetSize      = 0; // max. nr. of active states at once
+  long threadsSpawned      = 0; // by NFA::accepts1
+  long backtracks          = 0; // failed recursive calls in NFA::accepts2
+  long refinementPasses    = 0; // of table filling in DFA::minimalOf
+}; // FAStats
+
+#ifdef DO_FA_STATS
+  #define FA_STAT(stmt) stmt
+#else
+  #define FA_STAT(stmt)
+#endif
+
+
+// GraphVizOptions: limits for writing huge automata to GraphViz files
+struct GraphVizOptions {
+  int maxStates   = 0; // > 0: only the first maxStates states (in the
+                       //   order of the listing), transitions to the
+                       //   others end in one "..." node
+  int clusterSize = 0; // > 0: groups of clusterSize states (in the order
+                       //   of the listing) in subgraphs cluster_0, ...
+}; // GraphVizOptions
+
+
+// transition graph of an FA in integer form (StateIds of a StateIndex):
+//   graph[src] holds pairs (tSy, dest), tSy == eps for eps. transitions
+typedef std::vector<std::vector<std::pair<TapeSymbol, StateId>>> FAGraph;
 
 
 class FA {  // abstract base class for DFA and NFA
@@ -38,9 +75,22 @@ class FA {  // abstract base class for DFA and NFA
     //   returns StateSet even for DFA, in this case with one element
     virtual StateSet deltaAt(const State &src, TapeSymbol tSy) const = 0;
 
-    // used by operator<< and writeToGraphVizFile only
+    // appends the transitions of src as pairs (tSy, dest), dest as id of
+    //   stateIndex(), to transitions, ordered by symbols (eps. first) and
+    //   dest. states, used by bfsOrder, graphOf and writeGraphViz
+    virtual void appendTransitionsOf(StateId src,
+      std::vector<std::pair<TapeSymbol, StateId>> &transitions) const = 0;
+
+    // used by operator<< and DFA::renamedOf, states of bfsOrder()
     std::vector<State> topSortedStates() const; // topological sort
 
+    // used by the language queries below
+    FAGraph graphOf() const; // on the ids of stateIndex()
+
+#ifdef DO_FA_STATS
+    mutable FAStats statistics; // updated by const methods via FA_STAT
+#endif
+
   public:
 
     const StateSet      S;     // set of states       (cf. "nonterminals")
@@ -53,8 +103,50 @@ class FA {  // abstract base class for DFA and NFA
 
     virtual bool accepts(const Tape &tape) const = 0;
 
+    // StateIds of the integer tables of DFA and NFA, index of S
+    virtual const StateIndex &stateIndex() const = 0;
+
+    // states reachable from s1 (as ids of stateIndex()) in breadth-first
+    //   order, successors by symbols (eps. first) and names, so the order
+    //   of topSortedStates, in O(|S| + |delta|) with a visited bitmap
+    std::vector<StateId> bfsOrder() const;
+
+    // counters since construction or last resetStats(), not synchronized,
+    //   so only for FAs used by one thread at a time
+    FAStats stats() const {
+#ifdef DO_FA_STATS
+      return statistics;
+#else
+      return FAStats();
+#endif
+    } // stats
+
+    void resetStats() const {
+      FA_STAT(statistics = FAStats());
+    } // resetStats
+
+    // language queries, all linear in the size of the transition graph
+    //   (BFS from s1, cycle detection in the trimmed automaton):
+    bool isEmpty()  const; // L(this) == {}?
+    bool isFinite() const; // |L(this)| finite?
+
+    // shortest tape accepted, false (and witness unchanged) if L is empty
+    bool shortestWitness(Tape &witness) const;
+
+    // u v^k w is accepted for all k >= 0 with v != "", so L is infinite,
+    //   false (and u, v, w unchanged) if L is finite
+    bool pumpingWitness(Tape &u, Tape &v, Tape &w) const;
+
+    // streams the automaton in GraphViz's dot language to os, in one
+    //   pass over the transitions of each state, O(|S| + |delta|)
+    void writeGraphViz(std::ostream &os, const std::string &name = "",
+                       const GraphVizOptions &options =
+                         GraphVizOptions()) const;
+
     void genGraphVizFile(const std::string &fileName,
-                         const std::string &name = "") const;
+                         const std::string &name = "",
+                         const GraphVizOptions &options =
+                           GraphVizOptions()) const;
 
 }; // FA
 
@@ -24,6 +24,9 @@ using namespace std;
 #include "FABuilder.h"
 
 #include "Moore.h"
+#include "Mealy.h"
+#include "AllocTracker.h"
+#include "Timer.h"
 
 
 void FABuilder::checkStates() const {
@@ -37,7 +40,8 @@ void FABuilder::checkStates() const {
     throw logic_error("no end state(s) defined");
   if (delta.find(s1) == delta.end())
     throw logic_error("start state is not in delta's domain");
-  StateSet reachableStates(s1); // start state is reachable
+  StateSet reachableStates(S.get_allocator());
+  reachableStates.insert(s1); // start state is reachable
   size_t oldSize, newSize = 1;
   do {
     oldSize = newSize;
@@ -61,6 +65,7 @@ static string initMessageOf(int lnr, const string &msg) {
 } // initMessageOf
 
 void FABuilder::initFromStream(istream &is) {
+  TIME_PHASE("FABuilder::initFromStream");
   string line, sy, state, arrowSy, destState;
   bool isStartState, isFinalState;
   int  lnr = 0;
@@ -142,6 +147,12 @@ FABuilder::FABuilder(const char *str) {
   initFromStream(iss);
 } // FABuilder::FABuilder
 
+FABuilder::FABuilder(pmr::memory_resource *mr)
+: S(StateSet::allocator_type(mr)),
+  delta(Delta<StateSet>::allocator_type(mr)),
+  F(StateSet::allocator_type(mr)) {
+} // FABuilder::FABuilder
+
 
 FABuilder &FABuilder::setStartState(const State &s) {
   if (s1 != State())
@@ -202,6 +213,13 @@ FABuilder& FABuilder::setLambda(map<State, char> lambda) {
 } // FABuilder::setLambda
 
 
+FABuilder &FABuilder::setMealyLambda(
+           const map<pair<State, TapeSymbol>, char> &lambda) {
+  mealyLambda = lambda;
+  return *this;
+} // FABuilder::setMealyLambda
+
+
 bool FABuilder::representsDFA() const {
   for (const auto &t: delta.transitions())
     if ( (t.tSy == eps) || // epsilon transition
@@ -212,6 +230,7 @@ bool FABuilder::representsDFA() const {
 
 
 FA *FABuilder::buildFA() const {
+  TRACK_ALLOCATIONS("FABuilder::buildFA");
   checkStates();
   if (representsDFA())
     return new DFA(S, V, s1, F, dDeltaOf(delta));
@@ -220,6 +239,8 @@ FA *FABuilder::buildFA() const {
 } // FABuilder::buildFA
 
 DFA *FABuilder::buildDFA() const {
+  TIME_PHASE("FABuilder::buildDFA");
+  TRACK_ALLOCATIONS("FABuilder::buildDFA");
   if (!representsDFA())
     throw domain_error("cannot build DFA, builder's delta represents an NFA");
   checkStates();
@@ -227,15 +248,26 @@ DFA *FABuilder::buildDFA() const {
 } // FABuilder::buildDFA
 
 NFA *FABuilder::buildNFA() const {
+  TIME_PHASE("FABuilder::buildNFA");
+  TRACK_ALLOCATIONS("FABuilder::buildNFA");
   checkStates();
   return new NFA(S, V, s1, F, delta);
 } // FABuilder::buildNFA
 
 
 Moore* FABuilder::buildMoore() const{
+   TRACK_ALLOCATIONS("FABuilder::buildMoore");
    return new Moore(S, V, s1, F, dDeltaOf(delta), lambda);
 } // FABuilder::buildMoore
 
+Mealy *FABuilder::buildMealy() const {
+  TRACK_ALLOCATIONS("FABuilder::buildMealy");
+  if (!representsDFA())
+    throw domain_error("cannot build Mealy, builder's delta represents an NFA");
+  checkStates();
+  return new Mealy(S, V, s1, F, dDeltaOf(delta), mealyLambda);
+} // FABuilder::buildMealy
+
 
 void FABuilder::clear() {
   S.clear();
@@ -243,6 +275,8 @@ void FABuilder::clear() {
   delta.clear();
   s1 = State();
   F.clear();
+  lambda.clear();
+  mealyLambda.clear();
 } // FABuilder::clear
 
 
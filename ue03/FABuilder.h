@@ -10,7 +10,10 @@
 
 #include <initializer_list>
 #include <iosfwd>
+#include <map>
+#include <memory_resource>
 #include <string>
+#include <utility>
 
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
@@ -22,10 +25,8 @@ class FA;    // forward declarations for ...
 class DFA;   //    ... the return types in ...
 class NFA;   //    ... the build methods below
 class Moore;
+class Mealy;
 
-#ifdef MEALY_DFA
-class MealyDFA;
-#endif
 #ifdef MOORE_DFA
 class MooreDFA;
 #endif
@@ -43,6 +44,7 @@ class FABuilder final // no public base class
     State           s1;    // start state, an element of S
     StateSet        F;     // set of final states, a subset of S
     map<State, char> lambda;
+    std::map<std::pair<State, TapeSymbol>, char> mealyLambda;
 
     void checkStates() const;
 
@@ -57,6 +59,8 @@ class FABuilder final // no public base class
     FABuilder() = default; // empty builder, needs programmatical init.
     FABuilder(const std::string &fileName); // init. from text file
     FABuilder(const char        *str);      // init. from C string (e.g., in the source)
+    FABuilder(std::pmr::memory_resource *mr); // empty builder, allocates
+      // its states and delta in mr, e.g., in an Arena for transformations
 
     FABuilder &operator==(const FABuilder  &fab) = delete;
     FABuilder &operator==(      FABuilder &&fab) = delete;
@@ -79,6 +83,8 @@ class FABuilder final // no public base class
                const State &src, TapeSymbol tSy, std::initializer_list<State> il);
 
     FABuilder& setLambda(map<State, char> lambda);
+    FABuilder &setMealyLambda( // output for each transition (src, tSy)
+               const std::map<std::pair<State, TapeSymbol>, char> &lambda);
 
     // build methods:
 
@@ -89,6 +95,7 @@ class FABuilder final // no public base class
     NFA *buildNFA() const;  // always works
 
     Moore* buildMoore() const;
+    Mealy *buildMealy() const; // requires: representsDFA() == true
 
     // finally, a clear method that allows reuse or the builder:
 
@@ -0,0 +1,237 @@
+// FAGenerator.cpp:                                            HDO, 2021
+// ---------------
+// FAGenerator generates random finite automata in the text syntax of
+// FABuilder and random right-linear grammars in the text syntax of
+// GrammarBuilder, e.g., for scaling benchmarks. For one seed and one
+// set of parameters the generated texts are always the same.
+// Static methods provide known worst cases.
+//======================================================================
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+#include "FAGenerator.h"
+
+
+static string stateName(int i) {
+  return "q" + to_string(i);
+} // stateName
+
+static string ntName(int i) { // nonterminals must not clash with terminals
+  return "N" + to_string(i);
+} // ntName
+
+
+// --- implementation of class FAGenerator ---
+
+FAGenerator::FAGenerator(unsigned seed)
+: seed(seed), nStates(10), nSymbols(2),
+  density(0.8), nondet(1.5), epsDensity(0.1), finalRatio(0.2) {
+} // FAGenerator::FAGenerator
+
+
+FAGenerator &FAGenerator::setSeed(unsigned seed) {
+  this->seed = seed;
+  return *this;
+} // FAGenerator::setSeed
+
+FAGenerator &FAGenerator::setNrOfStates(int n) {
+  if (n < 1)
+    throw invalid_argument("number of states must be >= 1");
+  nStates = n;
+  return *this;
+} // FAGenerator::setNrOfStates
+
+FAGenerator &FAGenerator::setAlphabetSize(int n) {
+  if (n < 1 || n > 26)
+    throw invalid_argument("alphabet size must be in 1 .. 26");
+  nSymbols = n;
+  return *this;
+} // FAGenerator::setAlphabetSize
+
+FAGenerator &FAGenerator::setDensity(double p) {
+  if (p < 0.0 || p > 1.0)
+    throw invalid_argument("density must be in 0 .. 1");
+  density = p;
+  return *this;
+} // FAGenerator::setDensity
+
+FAGenerator &FAGenerator::setNondeterminism(double d) {
+  if (d < 1.0)
+    throw invalid_argument("degree of nondeterminism must be >= 1");
+  nondet = d;
+  return *this;
+} // FAGenerator::setNondeterminism
+
+FAGenerator &FAGenerator::setEpsDensity(double p) {
+  if (p < 0.0 || p > 1.0)
+    throw invalid_argument("epsilon density must be in 0 .. 1");
+  epsDensity = p;
+  return *this;
+} // FAGenerator::setEpsDensity
+
+FAGenerator &FAGenerator::setFinalRatio(double p) {
+  if (p < 0.0 || p > 1.0)
+    throw invalid_argument("final ratio must be in 0 .. 1");
+  finalRatio = p;
+  return *this;
+} // FAGenerator::setFinalRatio
+
+
+vector<FAGenerator::Transition> FAGenerator::transitions(
+                           mt19937 &rng, bool deterministic) const {
+  uniform_int_distribution<int> stateDist(0, nStates - 1);
+  uniform_real_distribution<double> prob(0.0, 1.0);
+  vector<Transition> ts;
+  // used[s * nSymbols + a]: (s, a) already has a transition
+  vector<bool> used(nStates * nSymbols, false);
+
+  // 1. random spanning tree: state i is reached from one of q0 .. qi-1
+  for (int dest = 1; dest < nStates; dest++) {
+    int src, a;
+    do {                   // find a free (src, a), there are enough
+      src = uniform_int_distribution<int>(0, dest - 1)(rng);
+      a   = uniform_int_distribution<int>(0, nSymbols - 1)(rng);
+    } while (used[src * nSymbols + a]);
+    used[src * nSymbols + a] = true;
+    ts.push_back({src, (char)('a' + a), dest});
+  } // for
+
+  // 2. further transitions according to density and nondeterminism
+  for (int src = 0; src < nStates; src++)
+    for (int a = 0; a < nSymbols; a++) {
+      bool hasTree = used[src * nSymbols + a];
+      if (!hasTree && prob(rng) >= density)
+        continue;          // no transition for (src, a)
+      int nDests = deterministic ? 1 : (int)nondet;
+      if (!deterministic && prob(rng) < nondet - (int)nondet)
+        nDests++;
+      for (int i = hasTree ? 1 : 0; i < nDests; i++)
+        ts.push_back({src, (char)('a' + a), stateDist(rng)});
+    } // for
+
+  if (ts.empty())           // FABuilder requires at least one transition
+    ts.push_back({0, 'a', 0});
+
+  // 3. epsilon transitions
+  if (!deterministic)
+    for (int src = 0; src < nStates; src++)
+      if (prob(rng) < epsDensity)
+        ts.push_back({src, '\0', stateDist(rng)}); // '\0' for eps
+
+  // sort by source state for output, remove duplicates
+  sort(ts.begin(), ts.end(), [](const Transition &t1, const Transition &t2) {
+    return t1.src != t2.src ? t1.src < t2.src :
+           t1.tSy != t2.tSy ? t1.tSy < t2.tSy : t1.dest < t2.dest;
+  });
+  ts.erase(unique(ts.begin(), ts.end(), [](const Transition &t1, const Transition &t2) {
+    return t1.src == t2.src && t1.tSy == t2.tSy && t1.dest == t2.dest;
+  }), ts.end());
+  return ts;
+} // FAGenerator::transitions
+
+
+vector<bool> FAGenerator::finalStates(mt19937 &rng) const {
+  uniform_real_distribution<double> prob(0.0, 1.0);
+  vector<bool> isFinal(nStates, false);
+  bool anyFinal = false;
+  for (int s = 0; s < nStates; s++)
+    anyFinal |= isFinal[s] = prob(rng) < finalRatio;
+  if (!anyFinal)
+    isFinal[uniform_int_distribution<int>(0, nStates - 1)(rng)] = true;
+  return isFinal;
+} // FAGenerator::finalStates
+
+
+string FAGenerator::faText(bool deterministic) const {
+  mt19937 rng(seed);
+  vector<Transition> ts      = transitions(rng, deterministic);
+  vector<bool>       isFinal = finalStates(rng);
+  ostringstream oss;
+  size_t ti = 0;
+  for (int s = 0; s < nStates; s++) {
+    bool hasTransitions = ti < ts.size() && ts[ti].src == s;
+    if (!hasTransitions && s != 0 && !isFinal[s])
+      continue;            // state is a destination only
+    oss << (s == 0 ? "-> " : "   ") << (isFinal[s] ? "() " : "   ") <<
+           stateName(s) << " ->";
+    bool first = true;
+    for ( ; ti < ts.size() && ts[ti].src == s; ti++) {
+      oss << (first ? " " : " | ") <<
+             (ts[ti].tSy == '\0' ? string("eps") : string(1, ts[ti].tSy)) <<
+             " " << stateName(ts[ti].dest);
+      first = false;
+    } // for
+    oss << "\n";
+  } // for
+  return oss.str();
+} // FAGenerator::faText
+
+string FAGenerator::dfaText() const {
+  return faText(true);
+} // FAGenerator::dfaText
+
+string FAGenerator::nfaText() const {
+  return faText(false);
+} // FAGenerator::nfaText
+
+
+string FAGenerator::grammarText() const {
+  // grammar of an NFA without eps. transitions: A -> a B for each
+  //   transition (A, a) -> B, plus A -> a if B is final
+  mt19937 rng(seed);
+  vector<Transition> ts      = transitions(rng, false);
+  vector<bool>       isFinal = finalStates(rng);
+  vector<vector<string>> alternatives(nStates);
+  for (const Transition &t: ts) {
+    if (t.tSy == '\0')
+      continue;            // no eps. transitions in right-linear grammars
+    alternatives[t.src].push_back(string(1, t.tSy) + " " + ntName(t.dest));
+    if (isFinal[t.dest])
+      alternatives[t.src].push_back(string(1, t.tSy));
+  } // for
+  if (isFinal[0])
+    alternatives[0].push_back("eps");
+  ostringstream oss;
+  oss << "G(" << ntName(0) << "):\n";
+  for (int s = 0; s < nStates; s++) {
+    vector<string> &alts = alternatives[s];
+    sort(alts.begin(), alts.end());
+    alts.erase(unique(alts.begin(), alts.end()), alts.end());
+    if (alts.empty())      // each nonterminal needs a rule, a self-loop
+      alts.push_back("a " + ntName(s)); //   keeps it unproductive
+    oss << ntName(s) << " ->";
+    for (size_t i = 0; i < alts.size(); i++)
+      oss << (i == 0 ? " " : " | ") << alts[i];
+    oss << "\n";
+  } // for
+  return oss.str();
+} // FAGenerator::grammarText
+
+
+string FAGenerator::nthFromEndText(int n) {
+  if (n < 1)
+    throw invalid_argument("n must be >= 1");
+  ostringstream oss;
+  oss << "-> " << stateName(0) << " -> a " << stateName(0) <<
+         " | a " << stateName(1) << " | b " << stateName(0) << "\n";
+  for (int i = 1; i < n; i++)
+    oss << "   " << stateName(i) << " -> a " << stateName(i + 1) <<
+           " | b " << stateName(i + 1) << "\n";
+  oss << "() " << stateName(n) << " ->\n";
+  return oss.str();
+} // FAGenerator::nthFromEndText
+
+
+string FAGenerator::ambiguousLoopsText() {
+  return "-> A -> a A | a B | b F \n"
+         "   B -> a A | a B | b F \n"
+         "() F ->                 \n";
+} // FAGenerator::ambiguousLoopsText
+
+
+// end of FAGenerator.cpp
+//======================================================================
@@ -0,0 +1,78 @@
+// FAGenerator.h:                                              HDO, 2021
+// -------------
+// FAGenerator generates random finite automata in the text syntax of
+// FABuilder and random right-linear grammars in the text syntax of
+// GrammarBuilder, e.g., for scaling benchmarks. For one seed and one
+// set of parameters the generated texts are always the same.
+// Static methods provide known worst cases.
+//======================================================================
+
+#ifndef FAGenerator_h
+#define FAGenerator_h
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ObjectCounter.h"
+
+
+class FAGenerator final // no public base class
+            /*OC+*/ : private ObjectCounter<FAGenerator> /*+OC*/ {
+
+  private:
+
+    unsigned seed;
+    int      nStates;      // number of states, named q0, q1, ...
+    int      nSymbols;     // size of alphabet, symbols a, b, ...
+    double   density;      // probability of a transition for (state, symbol)
+    double   nondet;       // average nr. of dest. states per transition
+    double   epsDensity;   // probability of an eps. transition per state
+    double   finalRatio;   // probability of a state being final
+
+    struct Transition { int src; char tSy; int dest; };
+
+    std::vector<Transition> transitions(std::mt19937 &rng,
+                                        bool deterministic) const;
+    std::vector<bool>       finalStates(std::mt19937 &rng) const;
+
+    std::string faText(bool deterministic) const;
+
+  public:
+
+    FAGenerator(unsigned seed = 4711);
+
+    // following methods for setting the parameters provide a fluent interface:
+
+    FAGenerator &setSeed       (unsigned seed);
+    FAGenerator &setNrOfStates (int n);      // >= 1,     default: 10
+    FAGenerator &setAlphabetSize(int n);     // 1 .. 26,  default: 2
+    FAGenerator &setDensity    (double p);   // 0 .. 1,   default: 0.8
+    FAGenerator &setNondeterminism(double d);// >= 1,     default: 1.5
+    FAGenerator &setEpsDensity (double p);   // 0 .. 1,   default: 0.1
+    FAGenerator &setFinalRatio (double p);   // 0 .. 1,   default: 0.2
+
+    // generation methods: all states are reachable from start state q0,
+    //   at least one state is final
+
+    std::string dfaText()     const; // for FABuilder, ignores nondet. and eps.
+    std::string nfaText()     const; // for FABuilder
+    std::string grammarText() const; // for GrammarBuilder, right-linear,
+                                     //   ignores eps. density
+
+    // known worst cases:
+
+    // L = {a, b}* a {a, b}^(n - 1): n + 1 states, DFA has 2^n states
+    static std::string nthFromEndText(int n);
+
+    // (a | a)* b with ambiguous a-loops: accepts2 (backtracking) needs
+    //   time exponential in the length of tapes a^k without b
+    static std::string ambiguousLoopsText();
+
+}; // FAGenerator
+
+
+#endif
+
+// end of FAGenerator.h
+//======================================================================
@@ -18,6 +18,8 @@ using namespace std;
 #include "GrammarBasics.h"
 #include "Grammar.h"
 #include "GrammarBuilder.h"
+#include "AllocTracker.h"
+#include "Timer.h"
 
 
 // === implementation of class GrammarBuilder ==========================
@@ -30,6 +32,8 @@ void GrammarBuilder::initialize(NTSymbol *root) {
 
 
 void GrammarBuilder::readGrammar(istream &is) {
+  TIME_PHASE("GrammarBuilder::readGrammar");
+  TRACK_ALLOCATIONS("GrammarBuilder::readGrammar");
   string line, sy, rootNt, nt, ntSy, arrowSy;
   bool firstNonEmptyLine;
   unordered_map<string, NTSymbol *> ntMap;
@@ -213,6 +217,7 @@ void  GrammarBuilder::setNewRoot(NTSymbol *newRoot) {
 
 
 Grammar *GrammarBuilder::buildGrammar()  const {
+  TIME_PHASE("GrammarBuilder::buildGrammar");
   // 1. check if root nonterminal has a rule
   if (rules.find(root) == rules.end())
     throw invalid_argument("root nonterminal \"" +
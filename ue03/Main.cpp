@@ -22,6 +22,8 @@ using namespace std;
 #include "Moore.h"
 #include "FABuilder.h"
 #include "GraphVizUtil.h"
+#include "Benchmark.h"
+#include "SelfCheck.h"
 
 
 // Activation (1) allows simple builds via command line:
@@ -54,10 +56,6 @@ void	three_b();
 DFA*	three_c();
 void	three_d();
 
-void	measuredAccepts1(const Tape t, const NFA* fa, const int iterations);
-void	measuredAccepts2(const Tape t, const NFA* fa, const int iterations);
-void	measuredAccepts3(const Tape t, const NFA* fa, const int iterations);
-
 
 int main(int argc, char* argv[]) {
 
@@ -72,6 +70,13 @@ int main(int argc, char* argv[]) {
 
 	installSignalHandlers(); // to catch signals, especially SIGSEGV
 
+	if (argc > 1 && string(argv[1]) == "-bench") {
+		runBenchmarks(argc > 2 ? argv[2] : "");
+		return 0;
+	} // if
+	if (argc > 1 && string(argv[1]) == "-check")
+		return runSelfCheck() == 0 ? 0 : 1;
+
 	cout << "START: Main" << endl;
 	cout << endl;
 
@@ -382,69 +387,19 @@ void three_b()
 {
 	auto fa		= getNFAFromGrammar();
 
-	const string VALID_0	= "aaa";
-	const string VALID_1	= "bbb";
-	const string VALID_2	= "ccc";
-	const string VALID_3	= "abbbccca";
-	const string VALID_4	= "baaacb";
-	const string VALID_5	= "caaabc";
-	const string INVALID_0	= "abd";
-	const string INVALID_2	= "cbbbca";
-	const int	 ITERATIONS = 100;
-	
-	clock_t tstart = clock();
-	measuredAccepts1(VALID_0, fa, ITERATIONS);
-	measuredAccepts1(INVALID_0, fa, ITERATIONS);
-
-	clock_t t1 = clock() - tstart;
-	cout << "=== ACCEPTS1 ===" << endl;
-	cout << t1 << "ms for " << ITERATIONS << " Iterations" << endl;
-	cout << t1 / ITERATIONS << "ms Avg. per Iteraion for Accepts1" << endl;
-	cout << endl;
-
-	tstart = clock();
-	measuredAccepts2(VALID_0, fa, ITERATIONS);
-	measuredAccepts2(INVALID_0, fa, ITERATIONS);
-
-	clock_t t2 = clock() - tstart;
-	cout << "=== ACCEPTS2 ===" << endl;
-	cout << t2 << "ms for " << ITERATIONS << " Iterations" << endl;
-	cout << t2 / ITERATIONS << "ms Avg. per Iteraion for Accepts2" << endl;
-	cout << endl;
+	const Tape	TAPES[]	= { "aaa", "abd", "abbbccca", "cbbbca" };
 
-	tstart = clock();
-	measuredAccepts3(VALID_0, fa, ITERATIONS);
-	measuredAccepts3(INVALID_0, fa, ITERATIONS);
-
-	clock_t t3 = clock() - tstart;
-	cout << "=== ACCEPTS3 ===" << endl;
-	cout << t3 << "ms for " << ITERATIONS << " Iterations" << endl;
-	cout << t3 / ITERATIONS << "ms Avg. per Iteraion for Accepts3" << endl; 
-	cout << endl;
-}
-
-void measuredAccepts1(const Tape t, const NFA* fa, const int iterations)
-{
-	for (int i = 0; i < iterations; i++)
+	// see Benchmark.h, measure() repeats each call for at least 0.1 s
+	for (const Tape& t : TAPES)
 	{
-		fa->accepts1(t);
+		const long len = (long)t.length();
+		printMeasurement("accepts1", t, measure([&] { fa->accepts1(t); }), len);
+		printMeasurement("accepts2", t, measure([&] { fa->accepts2(t); }), len);
+		printMeasurement("accepts3", t, measure([&] { fa->accepts3(t); }), len);
 	}
-}
-
-void measuredAccepts2(const Tape t, const NFA* fa, const int iterations)
-{
-	for (int i = 0; i < iterations; i++)
-	{
-		fa->accepts2(t);
-	}
-}
+	cout << endl;
 
-void measuredAccepts3(const Tape t, const NFA* fa, const int iterations)
-{
-	for (int i = 0; i < iterations; i++)
-	{
-		fa->accepts3(t);
-	}
+	delete fa;
 }
 
 DFA* three_c()
@@ -6,6 +6,9 @@
 // A  row   in an MbMatrix is represented by a map-based vector (MbVector).
 // An entry in an MbMatrix can be seen as Triple consisting of
 //   two indices and a value: (i, j, v).
+// MbVector and MbMatrix are based on std::pmr::maps, so they can be
+//   allocated in an Arena (see Arena.h), rows and allocator-aware
+//   elements (e.g., StateSets) then are allocated in the arena too.
 //======================================================================
 
 #ifndef MbMatrix_h
@@ -13,7 +16,9 @@
 
 #include <iosfwd>
 #include <map>
+#include <memory_resource>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "ObjectCounter.h"
@@ -45,14 +50,36 @@ std::ostream &operator<<(std::ostream &os, const Triple<T1, T2, T3> &t) {
 // ---  generic class MbVector ---
 
 template<typename IdxT, typename ElemT>
-class MbVector: public  std::map<IdxT, ElemT>
+class MbVector: public  std::pmr::map<IdxT, ElemT>
       /*OC+*/ , private ObjectCounter<MbVector<IdxT, ElemT>> /*+OC*/ {
 
-    typedef std::map<IdxT, ElemT> Base;
+    typedef std::pmr::map<IdxT, ElemT> Base;
     static const ElemT constEmptyElement; // == ElemT()
 
   public:
 
+    typedef typename Base::allocator_type allocator_type;
+
+    MbVector() = default;
+    MbVector(const MbVector  &v) = default;
+    MbVector(      MbVector &&v) = default;
+
+    // allocator-extended constructors, e.g., for MbVectors in an Arena
+    explicit MbVector(const allocator_type &a)
+    : Base(a) {
+    } // MbVector
+
+    MbVector(const MbVector &v, const allocator_type &a)
+    : Base(v, a) {
+    } // MbVector
+
+    MbVector(MbVector &&v, const allocator_type &a)
+    : Base(std::move(v), a) {
+    } // MbVector
+
+    MbVector &operator=(const MbVector  &v) = default;
+    MbVector &operator=(      MbVector &&v) = default;
+
     using Base::operator[]; // prevent hiding for non-const objects
 
     // non-inserting operator[] for const MbVector objects
@@ -73,14 +100,36 @@ const ElemT MbVector<IdxT, ElemT>::constEmptyElement = ElemT();
 // ---  generic class MbMatrix ---
 
 template<typename IdxT1, typename IdxT2, typename ElemT>
-class MbMatrix: public  std::map<IdxT1, MbVector<IdxT2, ElemT>>
+class MbMatrix: public  std::pmr::map<IdxT1, MbVector<IdxT2, ElemT>>
       /*OC+*/ , private ObjectCounter<MbMatrix<IdxT1, IdxT2, ElemT>> /*+OC*/ {
 
-    typedef std::map<IdxT1, MbVector<IdxT2, ElemT>> Base;
+    typedef std::pmr::map<IdxT1, MbVector<IdxT2, ElemT>> Base;
     static const MbVector<IdxT2, ElemT> constEmptyVector; // == MbVector<..>()
 
   public:
 
+    typedef typename Base::allocator_type allocator_type;
+
+    MbMatrix() = default;
+    MbMatrix(const MbMatrix  &m) = default;
+    MbMatrix(      MbMatrix &&m) = default;
+
+    // allocator-extended constructors, e.g., for MbMatrixes in an Arena
+    explicit MbMatrix(const allocator_type &a)
+    : Base(a) {
+    } // MbMatrix
+
+    MbMatrix(const MbMatrix &m, const allocator_type &a)
+    : Base(m, a) {
+    } // MbMatrix
+
+    MbMatrix(MbMatrix &&m, const allocator_type &a)
+    : Base(std::move(m), a) {
+    } // MbMatrix
+
+    MbMatrix &operator=(const MbMatrix  &m) = default;
+    MbMatrix &operator=(      MbMatrix &&m) = default;
+
     using Base::operator[]; // prevent hiding for non-const objects
 
     // non-inserting operator[] for const MbMatrix objects
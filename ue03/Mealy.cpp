@@ -0,0 +1,116 @@
+// Mealy.cpp:                                                   HDO, 2021
+// ---------
+// Objects of class Mealy represent Mealy machines, see Mealy.h.
+//======================================================================
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "TableStuff.h"
+#include "Mealy.h"
+#include "FABuilder.h"
+
+
+// --- implementation of class StreamSink ---
+
+void StreamSink::write(const char *block, size_t len) {
+  os.write(block, (streamsize)len);
+} // StreamSink::write
+
+
+// --- implementation of class Mealy ---
+
+Mealy::Mealy(const StateSet    &S,  const TapeSymbolSet &V,
+             const State       &s1, const StateSet      &F,
+             const DDelta      &delta,
+             const MealyLambda &lambda)
+: DFA(S, V, s1, F, delta), nSymbols(0), startRow(0), lambda(lambda) {
+  nSymbols = vIdx.size();  // integer tables of DFA
+  if ((long long)sIdx.size() * nSymbols >= (1LL << 24))
+    throw length_error("too many states for Mealy table");
+  for (int i = 0; i < 256; i++)
+    symIdx[i] = vIdx.indexOf((TapeSymbol)i);
+  vector<int> output(sIdx.size() * nSymbols, -1); // -1: no lambda
+  for (const auto &tl: this->lambda) {
+    StateId src = sIdx.idOf(tl.first.first);
+    int     a   = vIdx.indexOf(tl.first.second);
+    if (src == undefId || a < 0 || table.destAt(src, a) == undefId)
+      throw invalid_argument("lambda for undefined transition (" +
+                             tl.first.first + ", " +
+                             stringOf(tl.first.second) + ")");
+    output[src * nSymbols + a] = (unsigned char)tl.second;
+  } // for
+  cells.assign(sIdx.size() * nSymbols, undefCell);
+  for (StateId src = 0; src < sIdx.size(); src++)
+    for (int a = 0; a < nSymbols; a++) {
+      StateId dest = table.destAt(src, a);
+      int     idx  = src * nSymbols + a;
+      if (dest == undefId)
+        continue;
+      if (output[idx] < 0)
+        cells[idx] = noOutputCell;
+      else
+        cells[idx] = (uint32_t)(dest * nSymbols) << 8 | output[idx];
+    } // for
+  startRow = (uint32_t)(start * nSymbols);
+} // Mealy::Mealy
+
+
+void Mealy::throwNoOutput(uint32_t cellIdx) const {
+  throw out_of_range("lambda undefined for transition (" +
+                     sIdx.stateAt(cellIdx / nSymbols) + ", " +
+                     stringOf(vIdx.symbolAt(cellIdx % nSymbols)) + ")");
+} // Mealy::throwNoOutput
+
+
+bool Mealy::accepts(const Tape &tape) const {
+  StreamSink sink(cout);
+  return transduce(tape, sink);
+} // Mealy::accepts
+
+
+bool Mealy::transduce(const Tape &tape, OutputSink &sink) const {
+  char   block[blockSize];
+  size_t len = 0;
+  uint32_t row = startRow;
+  bool accepted = true;
+  for (const unsigned char *p = (const unsigned char *)tape.c_str();
+       *p != eot; p++) {
+    int a = symIdx[*p];
+    uint32_t cell = a < 0 ? undefCell : cells[row + a];
+    if (cell >= noOutputCell) {
+      if (cell == undefCell) {
+        accepted = false;
+        break;
+      } // if
+      sink.write(block, len);
+      throwNoOutput(row + a);
+    } // if
+    row = cell >> 8;
+    block[len++] = (char)(cell & 0xFF);
+    if (len == blockSize) {
+      sink.write(block, len);
+      len = 0;
+    } // if
+  } // for
+  if (len > 0)
+    sink.write(block, len);
+  return accepted && isFinal[row / nSymbols]; // V is never empty
+} // Mealy::transduce
+
+string Mealy::transduce(const Tape &tape) const {
+  StringSink sink;
+  sink.str.reserve(tape.length());
+  transduce(tape, sink);
+  return move(sink.str);
+} // Mealy::transduce
+
+
+// end of Mealy.cpp
+//======================================================================
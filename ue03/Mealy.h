@@ -0,0 +1,129 @@
+// Mealy.h:                                                     HDO, 2021
+// -------
+// Objects of class Mealy represent Mealy machines: DFAs with an output
+// lambda(s, a) for each transition (s, a) -> s'. The transitions and
+// outputs are compiled into one table, each entry packs the next state
+// and the output into one word. OutputSink receives the output of a
+// transduction in blocks.
+//======================================================================
+
+#ifndef Mealy_h
+#define Mealy_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DFA.h"
+
+
+// receiver for the output of transductions, called once per block of
+//   output symbols, not per symbol
+class OutputSink {
+
+  public:
+
+    virtual ~OutputSink() = default;
+
+    virtual void write(const char *block, size_t len) = 0;
+
+}; // OutputSink
+
+class StringSink: public OutputSink { // appends blocks to a string
+
+  public:
+
+    std::string str;
+
+    virtual void write(const char *block, size_t len) override {
+      str.append(block, len);
+    } // write
+
+}; // StringSink
+
+class StreamSink: public OutputSink { // writes blocks to an ostream
+
+  private:
+
+    std::ostream &os;
+
+  public:
+
+    explicit StreamSink(std::ostream &os)
+    : os(os) {
+    } // StreamSink
+
+    virtual void write(const char *block, size_t len) override;
+
+}; // StreamSink
+
+
+class FABuilder;           // forward for friend declaration only
+
+typedef std::map<std::pair<State, TapeSymbol>, char> MealyLambda;
+
+class Mealy: public DFA
+ /*OC+*/ , private ObjectCounter<Mealy> /*+OC*/ {
+
+  friend class FABuilder;  // so ::build... methods can call prot. constr.
+
+  private:
+
+    typedef DFA Base;
+
+    // cell for (src, symbol) = row(dest) << 8 | lambda(src, symbol), with
+    //   row(dest) = dest * nSymbols, undefCell for undefined transitions,
+    //   noOutputCell for transitions without lambda (taking one throws)
+    static constexpr uint32_t undefCell    = 0xFFFFFFFF;
+    static constexpr uint32_t noOutputCell = 0xFFFFFFFE;
+
+    int                   nSymbols;
+    int                   symIdx[256]; // TapeSymbol -> column, -1 if not in V
+    std::vector<uint32_t> cells;       // cells[src * nSymbols + column]
+    uint32_t              startRow;
+
+    [[noreturn]] void throwNoOutput(uint32_t cellIdx) const;
+
+  protected:
+
+    // constructor called by FABuilder::build... methods only
+    Mealy(const StateSet    &S,  const TapeSymbolSet &V,
+          const State       &s1, const StateSet      &F,
+          const DDelta      &delta,
+          const MealyLambda &lambda);
+
+  public:
+
+    const MealyLambda lambda;
+
+    virtual ~Mealy() = default;
+
+    static constexpr size_t blockSize = 4096; // of output per sink.write
+
+    // acceptance test writing lambda of each transition taken to cout
+    virtual bool accepts(const Tape &tape) const;
+
+    // transduction: writes lambda of each transition taken (each char
+    //   incl. '\0' is a legal output) in blocks to sink, stops at
+    //   undefined transitions and returns acceptance, throws out_of_range
+    //   (after writing the output so far) on taking a transition without
+    //   lambda, like Moore on entering a state without lambda
+    bool transduce(const Tape &tape, OutputSink &sink) const;
+
+    // transduction returning the output only
+    std::string transduce(const Tape &tape) const;
+
+}; // Mealy
+
+
+#endif
+
+// end of Mealy.h
+//======================================================================
@@ -1,6 +1,6 @@
-// DFA.cpp:                                               HDO, 2006-2019
-// -------
-// Objects of class DFA represent deterministic finite automata.
+// Moore.cpp:                                             HDO, 2006-2019
+// ---------
+// Objects of class Moore represent Moore machines, see Moore.h.
 //======================================================================
 
 #include <cmath>
@@ -10,12 +10,16 @@
 #include <fstream>
 #include <map>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace std;
 
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "MbMatrix.h"
+#include "TableStuff.h"
 #include "Moore.h"
 #include "FABuilder.h"
 
@@ -26,13 +30,90 @@ Moore::Moore(const StateSet &S,  const TapeSymbolSet &V,
          const State    &s1, const StateSet      &F,
          const DDelta   &delta,
          const map<State, char> lambda)
-: DFA(S, V, s1, F, delta), lambda(lambda) {
+: DFA(S, V, s1, F, delta),
+  output(sIdx.size(), noOutput), lambda(lambda) {
+  for (const auto &sl: this->lambda) {
+    StateId id = sIdx.idOf(sl.first);
+    if (id == undefId)
+      throw invalid_argument("lambda for state " + sl.first + " not in S");
+    output[id] = (unsigned char)sl.second;
+  } // for
 } // Moore::Moore
 
 
-void Moore::onStateEntered(State s) const {
-   cout << lambda.at(s);
-} // Moore::onStateEntered
+void Moore::throwNoOutput(StateId s) const {
+  throw out_of_range("lambda undefined for state " + sIdx.stateAt(s));
+} // Moore::throwNoOutput
+
+
+bool Moore::accepts(const Tape &tape) const {
+  return transduce(tape, [](char ch) { cout << ch; });
+} // Moore::accepts
+
+
+bool Moore::transduce(const Tape &tape, string &out) const {
+  out.reserve(out.length() + tape.length());
+  return transduce(tape, [&out](char ch) { out.push_back(ch); });
+} // Moore::transduce
+
+string Moore::transduce(const Tape &tape) const {
+  string out;
+  transduce(tape, out);
+  return out;
+} // Moore::transduce
+
+
+// --- implementation of class CompiledMoore ---
+
+CompiledMoore::CompiledMoore(const Moore &m)
+: nSymbols(0) {
+  StateIndex  sIdx(m.S);
+  SymbolIndex vIdx(m.V);
+  if ((long)sIdx.size() * vIdx.size() >= (1L << 24))
+    throw length_error("too many states for CompiledMoore");
+  nSymbols = vIdx.size();
+  for (int i = 0; i < 256; i++)
+    symIdx[i] = vIdx.indexOf((TapeSymbol)i);
+  vector<int> output(sIdx.size(), Moore::noOutput);
+  for (const auto &sl: m.lambda)
+    output[sIdx.idOf(sl.first)] = (unsigned char)sl.second; // checked by Moore
+  DTable table(sIdx, vIdx, m.delta);
+  cells.assign(sIdx.size() * nSymbols, undefCell);
+  for (StateId src = 0; src < sIdx.size(); src++)
+    for (int a = 0; a < nSymbols; a++) {
+      StateId  dest = table.destAt(src, a);
+      uint32_t idx  = src * nSymbols + a;
+      if (dest == undefId)
+        continue;
+      if (output[dest] == Moore::noOutput) {
+        cells[idx] = noOutputCell;
+        noOutputDests[idx] = sIdx.stateAt(dest);
+      } else
+        cells[idx] = (uint32_t)(dest * nSymbols) << 8 | output[dest];
+    } // for
+  isFinal.assign(sIdx.size(), false);
+  for (const State &f: m.F)
+    isFinal[sIdx.idOf(f)] = true;
+  start = sIdx.idOf(m.s1);
+} // CompiledMoore::CompiledMoore
+
+
+void CompiledMoore::throwNoOutput(uint32_t cellIdx) const {
+  throw out_of_range("lambda undefined for state " +
+                     noOutputDests.at(cellIdx));
+} // CompiledMoore::throwNoOutput
+
+
+bool CompiledMoore::transduce(const Tape &tape, string &out) const {
+  out.reserve(out.length() + tape.length());
+  return transduce(tape, [&out](char ch) { out.push_back(ch); });
+} // CompiledMoore::transduce
+
+string CompiledMoore::transduce(const Tape &tape) const {
+  string out;
+  transduce(tape, out);
+  return out;
+} // CompiledMoore::transduce
 
 
 // end of Moore.cpp
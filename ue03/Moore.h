@@ -1,14 +1,25 @@
-// DFA.h:                                                 HDO, 2006-2019
-// -----
-// Objects of class DFA represent deterministic finite automata.
+// Moore.h:                                               HDO, 2006-2019
+// -------
+// Objects of class Moore represent Moore machines: DFAs with an output
+// lambda(s) for each state s, written for each state entered. lambda may
+// be undefined for states that are never entered (e.g., the start
+// state), entering such a state throws out_of_range (as lambda.at(s)).
+// CompiledMoore is a compact table form of a Moore machine for fast
+// transductions of long tapes.
 //======================================================================
 
 #ifndef Moore_h
 #define Moore_h
 
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
+#include "TableStuff.h"
 #include "DFA.h"
 
 
@@ -23,6 +34,11 @@ class Moore: public DFA
 
     typedef DFA Base;
 
+    std::vector<int> output; // StateId -> lambda (as unsigned char),
+                             //   noOutput if undefined
+
+    [[noreturn]] void throwNoOutput(StateId s) const;
+
   protected: // allows derived classes, e.g., for Mealy and or Moore
 
     // constructor called by FABuilder::build... methods only
@@ -37,11 +53,102 @@ class Moore: public DFA
 
     virtual ~Moore() = default;
 
-    virtual void onStateEntered(State s) const;
+    static constexpr int noOutput = -1; // for states without lambda
+
+    // acceptance test writing lambda of each state entered to cout
+    virtual bool accepts(const Tape &tape) const;
+
+    // transduction: calls sink(ch) with lambda of each state entered (as
+    //   accepts does, but without iostreams, each char incl. '\0' is a
+    //   legal output), stops at undefined transitions and returns
+    //   acceptance, throws out_of_range on entering a state without lambda
+    template<typename Sink>
+    bool transduce(const Tape &tape, Sink &&sink) const;
+
+    // transduction appending the output to out, returns acceptance
+    bool transduce(const Tape &tape, std::string &out) const;
+
+    // transduction returning the output only
+    std::string transduce(const Tape &tape) const;
 
 }; // Moore
 
 
+template<typename Sink>
+bool Moore::transduce(const Tape &tape, Sink &&sink) const {
+  struct OutputObserver: DFAObserver {
+    const Moore &moore;
+    Sink        &sink;
+    OutputObserver(const Moore &moore, Sink &sink)
+    : moore(moore), sink(sink) {
+    } // OutputObserver
+    void onTransition(StateId /*src*/, int /*symIdx*/, StateId dest) {
+      int out = moore.output[dest];
+      if (out == noOutput)
+        moore.throwNoOutput(dest);
+      sink((char)out);
+    } // onTransition
+  }; // OutputObserver
+  return run(tape, OutputObserver(*this, sink));
+} // Moore::transduce
+
+
+class CompiledMoore final // no public base class
+             /*OC+*/ : private ObjectCounter<CompiledMoore> /*+OC*/ {
+
+  private:
+
+    // cell for (src, symbol) = row(dest) << 8 | lambda(dest), with
+    //   row(dest) = dest * nSymbols, so each step needs one lookup in the
+    //   row of src only and no multiplication, noOutputCell if dest has
+    //   no lambda (entering it throws like Moore::transduce)
+    static constexpr uint32_t undefCell    = 0xFFFFFFFF;
+    static constexpr uint32_t noOutputCell = 0xFFFFFFFE;
+    int                   nSymbols;
+    int                   symIdx[256]; // TapeSymbol -> column, -1 if not in V
+    std::vector<uint32_t> cells;       // cells[src * nSymbols + column]
+    std::vector<char>     isFinal;     // StateId -> final?
+    StateId               start;
+    std::map<uint32_t, State> noOutputDests; // cell idx. -> dest without lambda
+
+    [[noreturn]] void throwNoOutput(uint32_t cellIdx) const;
+
+  public:
+
+    explicit CompiledMoore(const Moore &m);
+
+    // same as Moore::transduce
+    template<typename Sink>
+    bool transduce(const Tape &tape, Sink &&sink) const;
+
+    bool transduce(const Tape &tape, std::string &out) const;
+
+    std::string transduce(const Tape &tape) const;
+
+}; // CompiledMoore
+
+
+template<typename Sink>
+bool CompiledMoore::transduce(const Tape &tape, Sink &&sink) const {
+  uint32_t row = (uint32_t)start * nSymbols;
+  for (const unsigned char *p = (const unsigned char *)tape.c_str();
+       *p != eot; p++) {
+    int a = symIdx[*p];
+    if (a < 0)
+      return false;
+    uint32_t cell = cells[row + a];
+    if (cell >= noOutputCell) {
+      if (cell == undefCell)
+        return false;
+      throwNoOutput(row + a);
+    } // if
+    row = cell >> 8;
+    sink((char)(cell & 0xFF));
+  } // for
+  return isFinal[row / nSymbols];
+} // CompiledMoore::transduce
+
+
 #endif
 
 // end of Moore.h
@@ -0,0 +1,174 @@
+// MultiMatcher.cpp:                                            HDO, 2021
+// ----------------
+// Objects of class MultiMatcher match tapes against many patterns at
+// once, see MultiMatcher.h.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "TableStuff.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "MultiMatcher.h"
+
+
+MultiMatcher::MultiMatcher(const vector<const FA *> &patterns,
+                           size_t maxCachedStates)
+: nPatterns((int)patterns.size()), nSymbols(0),
+  maxCachedStates(max(maxCachedStates, (size_t)1)), nFlushes(0) {
+  // 1. union of the alphabets and of the states (all in integer form)
+  TapeSymbolSet V;
+  vector<StateIndex> sIdxs;
+  vector<StateId>    offsets; // of the states of each pattern
+  StateId nStates = 0;
+  for (const FA *fa: patterns) {
+    if (fa == nullptr)
+      throw invalid_argument("pattern is nullptr");
+    V.insert(fa->V.begin(), fa->V.end());
+    sIdxs.emplace_back(fa->S);
+    offsets.push_back(nStates);
+    nStates += sIdxs.back().size();
+  } // for
+  vIdx     = SymbolIndex(V);
+  nSymbols = vIdx.size();
+  patternOf.resize(nStates);
+  isFinal  .assign(nStates, false);
+
+  // 2. rows of closed dests: for DFAs the dest only, for NFAs
+  //    the eps. closure of all dests
+  vector<Subset> rows((size_t)nStates * nSymbols);
+  for (int p = 0; p < nPatterns; p++) {
+    const FA         *fa   = patterns[p];
+    const StateIndex &sIdx = sIdxs[p];
+    const DFA        *dfa  = dynamic_cast<const DFA *>(fa);
+    const NFA        *nfa  = dynamic_cast<const NFA *>(fa);
+    auto closureOf = [&](const State &s) {
+      Subset c;
+      if (nfa != nullptr)
+        for (const State &cs: nfa->epsClosureOf(s))
+          c.push_back(offsets[p] + sIdx.idOf(cs));
+      else
+        c.push_back(offsets[p] + sIdx.idOf(s));
+      return c;
+    }; // closureOf
+    for (StateId s = 0; s < sIdx.size(); s++) {
+      patternOf[offsets[p] + s] = p;
+      isFinal  [offsets[p] + s] = fa->F.contains(sIdx.stateAt(s));
+    } // for
+    if (dfa != nullptr) {
+      for (const auto &t: dfa->delta.transitions())
+        rows[(size_t)(offsets[p] + sIdx.idOf(t.src)) * nSymbols +
+             vIdx.indexOf(t.tSy)] = closureOf(t.dest);
+    } else if (nfa != nullptr) {
+      for (const auto &t: nfa->delta.transitions()) {
+        if (t.tSy == eps)
+          continue;        // in the closures
+        Subset &row = rows[(size_t)(offsets[p] + sIdx.idOf(t.src)) *
+                           nSymbols + vIdx.indexOf(t.tSy)];
+        for (const State &dest: t.dest) {
+          Subset c = closureOf(dest);
+          row.insert(row.end(), c.begin(), c.end());
+        } // for
+      } // for
+    } else
+      throw invalid_argument("pattern is neither DFA nor NFA");
+    Subset start = closureOf(fa->s1);
+    startSubset.insert(startSubset.end(), start.begin(), start.end());
+  } // for
+  for (Subset &row: rows) { // sort and compress into one vector
+    sort(row.begin(), row.end());
+    row.erase(unique(row.begin(), row.end()), row.end());
+  } // for
+  sort(startSubset.begin(), startSubset.end());
+  startSubset.erase(unique(startSubset.begin(), startSubset.end()),
+                    startSubset.end());
+  rowStart.reserve(rows.size() + 1);
+  for (Subset &row: rows) {
+    rowStart.push_back((int)dests.size());
+    dests.insert(dests.end(), row.begin(), row.end());
+    Subset().swap(row);
+  } // for
+  rowStart.push_back((int)dests.size());
+
+  // 3. start state of lazy union DFA is cached state 0
+  flush();
+  nFlushes = 0;
+} // MultiMatcher::MultiMatcher
+
+
+// cached state for subset, a new one with its matches if not cached yet
+int MultiMatcher::cachedStateOf(Subset &&subset) {
+  auto it = idOf.find(subset);
+  if (it != idOf.end())
+    return it->second;
+  CachedState cs;
+  cs.next.assign(nSymbols, unknown);
+  for (StateId s: subset)
+    if (isFinal[s] &&
+        (cs.matches.empty() || cs.matches.back() != patternOf[s]))
+      cs.matches.push_back(patternOf[s]); // sorted as subset is sorted
+  cs.subset = move(subset);
+  int id = (int)cache.size();
+  idOf.emplace(cs.subset, id);
+  cache.push_back(move(cs));
+  return id;
+} // MultiMatcher::cachedStateOf
+
+// transition of cached state cs with symbol index a, computed and
+//   cached if unknown, may flush the cache, so cs is invalid afterwards
+int MultiMatcher::nextOf(int cs, int a) {
+  int next = cache[cs].next[a];
+  if (next != unknown)
+    return next;
+  Subset subset;
+  for (StateId s: cache[cs].subset) {
+    int r = s * nSymbols + a;
+    subset.insert(subset.end(),
+                  dests.begin() + rowStart[r], dests.begin() + rowStart[r + 1]);
+  } // for
+  if (subset.empty()) {
+    cache[cs].next[a] = dead;
+    return dead;
+  } // if
+  sort(subset.begin(), subset.end());
+  subset.erase(unique(subset.begin(), subset.end()), subset.end());
+  if (cache.size() >= maxCachedStates && idOf.find(subset) == idOf.end()) {
+    flush();               // bounded memory: restart with empty cache
+    return cachedStateOf(move(subset));
+  } // if
+  next = cachedStateOf(move(subset));
+  cache[cs].next[a] = next;
+  return next;
+} // MultiMatcher::nextOf
+
+void MultiMatcher::flush() {
+  cache.clear();
+  idOf.clear();
+  nFlushes++;
+  cachedStateOf(Subset(startSubset)); // start is always 0
+} // MultiMatcher::flush
+
+
+const vector<int> &MultiMatcher::matches(const Tape &tape) {
+  static const vector<int> noMatches;
+  int cs = 0;              // start state
+  for (const char *p = tape.c_str(); *p != eot; p++) {
+    int a = vIdx.indexOf(*p);
+    if (a < 0)
+      return noMatches;    // tape symbol not in any V
+    cs = nextOf(cs, a);
+    if (cs == dead)
+      return noMatches;
+  } // for
+  return cache[cs].matches;
+} // MultiMatcher::matches
+
+
+// end of MultiMatcher.cpp
+//======================================================================
@@ -0,0 +1,88 @@
+// MultiMatcher.h:                                              HDO, 2021
+// --------------
+// Objects of class MultiMatcher match tapes against many patterns, i.e.,
+// finite automata (DFAs or NFAs) identified by their index, at once:
+// the union of all patterns is determinized lazily (subset construction
+// on demand during matching), each state of this union DFA carries the
+// set of IDs of the patterns accepting in it, so one pass over a tape
+// reports all matching patterns. The number of cached states of the
+// union DFA is bounded, when the bound is reached the cache is flushed.
+//======================================================================
+
+#ifndef MultiMatcher_h
+#define MultiMatcher_h
+
+#include <unordered_map>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "TableStuff.h"
+#include "FA.h"
+
+
+class MultiMatcher final // no public base class
+            /*OC+*/ : private ObjectCounter<MultiMatcher> /*+OC*/ {
+
+  private:
+
+    // union of the patterns in integer form, each transition leads to
+    //   the eps. closure of its destinations, so no eps. transitions
+    int                  nPatterns;
+    int                  nSymbols;
+    SymbolIndex          vIdx;      // for the union of all V
+    std::vector<int>     rowStart;  // row r = s * nSymbols + a:
+    std::vector<StateId> dests;     //   dests[rowStart[r] .. rowStart[r + 1])
+    std::vector<int>     patternOf; // StateId -> ID of its pattern
+    std::vector<char>    isFinal;   // StateId -> final in its pattern?
+    Subset               startSubset;
+
+    // cached states of the lazy union DFA
+    static constexpr int unknown = -1; // transition not computed yet
+    static constexpr int dead    = -2; // transition to empty subset
+    struct CachedState {
+      Subset           subset;
+      std::vector<int> next;       // symbol index -> cached state
+      std::vector<int> matches;    // sorted IDs of accepting patterns
+    }; // CachedState
+    std::vector<CachedState>                    cache;
+    std::unordered_map<Subset, int, SubsetHash> idOf;
+    size_t                                      maxCachedStates;
+    long                                        nFlushes;
+
+    int cachedStateOf(Subset &&subset); // inserts if not cached yet
+    int nextOf(int cs, int a);          // computes and caches transition
+    void flush();
+
+  public:
+
+    // patterns[i] gets ID i, the patterns are not needed after construction
+    explicit MultiMatcher(const std::vector<const FA *> &patterns,
+                          size_t maxCachedStates = 10000);
+
+    MultiMatcher(const MultiMatcher &mm) = delete;
+    MultiMatcher &operator=(const MultiMatcher &mm) = delete;
+
+    // sorted IDs of all patterns accepting tape, valid until the next
+    //   call, not thread safe as the cache is updated
+    const std::vector<int> &matches(const Tape &tape);
+
+    int nrOfPatterns() const {
+      return nPatterns;
+    } // nrOfPatterns
+
+    size_t nrOfCachedStates() const {
+      return cache.size();
+    } // nrOfCachedStates
+
+    long nrOfFlushes() const { // since construction
+      return nFlushes;
+    } // nrOfFlushes
+
+}; // MultiMatcher
+
+
+#endif
+
+// end of MultiMatcher.h
+//======================================================================
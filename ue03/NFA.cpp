@@ -3,12 +3,17 @@
 // Objects of class NFA represent non-deterministic finite automata.
 //======================================================================
 
+#include <cmath>
 #include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
@@ -17,6 +22,7 @@
 
 using namespace std;
 
+#include "Arena.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "DeltaStuff.h"
@@ -24,6 +30,8 @@ using namespace std;
 #include "DFA.h"
 #include "NFA.h"
 #include "FABuilder.h"
+#include "AllocTracker.h"
+#include "Timer.h"
 
 
 // --- implementation of class NFA ---
@@ -32,7 +40,9 @@ using namespace std;
 NFA::NFA(const StateSet &S,  const TapeSymbolSet &V,
          const State    &s1, const StateSet      &F,
          const NDelta   &delta)
-: FA(S, V, s1, F), delta(delta) {
+: FA(S, V, s1, F), delta(delta),
+  sIdx(this->S), vIdx(this->V), table(sIdx, vIdx, this->delta),
+  epsClosures(table, sIdx.size()) {
 } // NFA::NFA
 
 
@@ -40,6 +50,15 @@ StateSet NFA::deltaAt(const State &src, TapeSymbol tSy) const {
   return delta[src][tSy];
 } // NFA::deltaAt
 
+void NFA::appendTransitionsOf(StateId src,
+    vector<pair<TapeSymbol, StateId>> &transitions) const {
+  for (StateId dest: table.epsDestsAt(src)) // eps sorts before all of V
+    transitions.emplace_back(eps, dest);
+  for (int a = 0; a < vIdx.size(); a++)
+    for (StateId dest: table.destsAt(src, a))
+      transitions.emplace_back(vIdx.symbolAt(a), dest);
+} // NFA::appendTransitionsOf
+
 
 bool NFA::accepts(const Tape &tape) const {
   bool ac1 = accepts1(tape);
@@ -57,6 +76,9 @@ bool NFA::accepts(const Tape &tape) const {
 
 static bool  accepted;
 static mutex mtx;  // used to synchronize access to variable accepted
+#ifdef DO_FA_STATS
+static atomic<long> threadsSpawned; // by accept1, all threads
+#endif
 
 static void accept1(const NDelta &delta, const StateSet &F,
                     const State &s, const Tape &tape, int i) {
@@ -74,14 +96,17 @@ static void accept1(const NDelta &delta, const StateSet &F,
     for (const State &tSyDest : delta[s][tSy]) // symbol transitions
       tv.push_back(thread(accept1, cref(delta), cref(F),
         tSyDest, tape, i + 1));
+  FA_STAT(threadsSpawned += (long)tv.size());
   for (auto &t : tv)
     t.join(); // join thread t with current thread
 } // accept1
 
 bool NFA::accepts1(const Tape &tape) const {
   accepted = false;
+  FA_STAT(threadsSpawned = 0);
   accept1(this->delta, this->F, this->s1, tape, 0); // normal call ...
                                        // ... within current thread
+  FA_STAT(statistics.threadsSpawned += threadsSpawned);
   return accepted;
 } // NFA::accepts1
 
@@ -95,38 +120,48 @@ bool NFA::accepts2(const Tape &tape) const { // public
 
 bool NFA::accepts2(const State &s,           // private
                    const Tape &tape, int i) const {
-  for (const State &epsDest : delta[s][eps]) // eps transitions
+  for (const State &epsDest : delta[s][eps]) { // eps transitions
     if (accepts2(epsDest, tape, i))  // recursive call
       return true;
+    FA_STAT(statistics.backtracks++);
+  } // for
   TapeSymbol tSy = tape[i];
   if (tSy == eot)
     return F.contains(s);  // accepted <==> s is final
-  for (const State &tSyDest : delta[s][tSy]) // symbol transitions
+  for (const State &tSyDest : delta[s][tSy]) { // symbol transitions
+    FA_STAT(statistics.transitionsFollowed++);
     if (accepts2(tSyDest, tape, i + 1)) // recursive call
       return true;
+    FA_STAT(statistics.backtracks++);
+  } // for
   return false;   // not accepted as no call succeeded
 } // NFA::accepts2
 
 
 // NFA::epsilonClosureOf (cf. Aho/Sethi/Ullman, p. 119):
 //----------------------
+// unions of the closures precomputed on construction (see EpsClosureTable)
 
 StateSet NFA::epsClosureOf(const State &src) const {
   return epsClosureOf(StateSet(src)); // see below
 } // NFA::epsClosureOf
 
 StateSet NFA::epsClosureOf(const StateSet &src) const {
-  StateSet ec  = src;
-  StateSet stc = src; // states to check
-  while (!stc.empty()) {
-    State s = stc.anyElement();
-    stc.erase(s);
-    for (const State &dest: delta[s][eps]) {
-      auto ir = ec.insert(dest);
-      if (ir.second)       // new state dest was inserted
-        stc.insert(dest);
-    } // for
-  } // while
+  FA_STAT(statistics.closureExpansions++);
+  StateSet ec;
+  vector<StateId> ids;
+  for (const State &s: src) {
+    StateId id = sIdx.idOf(s);
+    if (id == undefId)     // s not in S, so no epsilon transitions
+      ec.insert(s);
+    else
+      ids.insert(ids.end(), epsClosures.closureOf(id).begin(),
+                            epsClosures.closureOf(id).end());
+  } // for
+  sort(ids.begin(), ids.end()); // StateIds are in the order of the States
+  ids.erase(unique(ids.begin(), ids.end()), ids.end());
+  for (StateId id: ids)
+    ec.insert(ec.end(), sIdx.stateAt(id)); // hint makes insertion O(1)
   return ec;
 } // NFA::epsClosureOf
 
@@ -137,8 +172,10 @@ StateSet NFA::epsClosureOf(const StateSet &src) const {
 StateSet NFA::allDestsFor(const StateSet &src, TapeSymbol tSy) const {
   StateSet ad; // start with empty set for all destinations
   for (const State &s: src)
-    for (const State &dest: delta[s][tSy])
+    for (const State &dest: delta[s][tSy]) {
+      FA_STAT(statistics.transitionsFollowed++);
       ad.insert(dest);
+    } // for
   return ad;
 } // NFA::allDestsFor
 
@@ -150,12 +187,16 @@ bool NFA::accepts3(const Tape &tape) const {
   int        i   = 0;       // index of first symbol
   TapeSymbol tSy = tape[i]; // fetch first symbol
   StateSet   ss  = epsClosureOf(StateSet(s1));
+  FA_STAT(statistics.maxLiveSetSize =
+            max(statistics.maxLiveSetSize, (long)ss.size()));
 
   while (tSy != eot) {      // eot = end of tape
     StateSet dest = allDestsFor(ss, tSy);
     if (!defined(dest))
       return false;         // undefined, so no acceptance
     ss = epsClosureOf(dest);
+    FA_STAT(statistics.maxLiveSetSize =
+              max(statistics.maxLiveSetSize, (long)ss.size()));
     i++;
     tSy = tape[i];
   } // while
@@ -164,17 +205,89 @@ bool NFA::accepts3(const Tape &tape) const {
 } // NFA::accepts3
 
 
+// NFA::Simulator: like accepts3, but with preallocated integer sets
+//----------------
+
+NFA::Simulator::Simulator(const NFA &nfa)
+: nfa(nfa),
+  start(nfa.sIdx.idOf(nfa.s1)),
+  isFinal(nfa.sIdx.size(), false),
+  mark(nfa.sIdx.size(), 0), gen(0) {
+  for (const State &f: nfa.F)
+    isFinal[nfa.sIdx.idOf(f)] = true;
+  cur .reserve(nfa.sIdx.size()); // each state is added once per generation
+  next.reserve(nfa.sIdx.size());
+} // NFA::Simulator::Simulator
+
+
+void NFA::Simulator::nextGeneration() {
+  gen++;
+  if (gen == 0) {          // wrap around, so reset all marks
+    fill(mark.begin(), mark.end(), 0);
+    gen = 1;
+  } // if
+} // NFA::Simulator::nextGeneration
+
+
+void NFA::Simulator::addClosureOf(StateId s, vector<StateId> &ss) {
+  if (mark[s] == gen)
+    return;                // s (and its closure) is already in ss
+  FA_STAT(nfa.statistics.closureExpansions++);
+  for (StateId c: nfa.epsClosures.closureOf(s))
+    if (mark[c] != gen) {
+      mark[c] = gen;
+      ss.push_back(c);
+    } // if
+} // NFA::Simulator::addClosureOf
+
+
+bool NFA::Simulator::accepts(const Tape &tape) {
+  nextGeneration();
+  cur.clear();
+  addClosureOf(start, cur);
+  FA_STAT(nfa.statistics.maxLiveSetSize =
+            max(nfa.statistics.maxLiveSetSize, (long)cur.size()));
+  for (int i = 0; tape[i] != eot; i++) {
+    int a = nfa.vIdx.indexOf(tape[i]);
+    if (a < 0)
+      return false;        // tape symbol not in V, so no acceptance
+    nextGeneration();
+    next.clear();
+    for (StateId src: cur)
+      for (StateId dest: nfa.table.destsAt(src, a)) {
+        FA_STAT(nfa.statistics.transitionsFollowed++);
+        addClosureOf(dest, next);
+      } // for
+    if (next.empty())
+      return false;        // undefined, so no acceptance
+    FA_STAT(nfa.statistics.maxLiveSetSize =
+              max(nfa.statistics.maxLiveSetSize, (long)next.size()));
+    cur.swap(next);
+  } // for
+  for (StateId s: cur)
+    if (isFinal[s])
+      return true;
+  return false;
+} // NFA::Simulator::accepts
+
+
 // NFA::dfaOf (cf. Aho/Sethi/Ullman, p. 118):
 //-----------
 
 DFA *NFA::dfaOf() const {
+  TIME_PHASE("NFA::dfaOf");
+  TRACK_ALLOCATIONS("NFA::dfaOf");
 
-  FABuilder fab;
+  Arena     arena; // for all temporary data, released at once at the end
+  FABuilder fab(arena.resource());
 
   // 1. construct new delta function for DFA (S and V implicitly)
   StateSet       startStateSet = epsClosureOf(s1);
-  SetOfStateSets allStateSets = startStateSet;
-  SetOfStateSets sstc = startStateSet; // StateSets to check
+  SetOfStateSets allStateSets(arena.resource());
+  SetOfStateSets sstc        (arena.resource()); // StateSets to check
+  allStateSets.insert(startStateSet);
+  sstc        .insert(startStateSet);
+  FA_STAT(statistics.subsetStates++);
   while (!sstc.empty()) {
     StateSet srcStateSet = sstc.anyElement();
                            sstc.erase(srcStateSet);
@@ -185,6 +298,7 @@ DFA *NFA::dfaOf() const {
         if (!allStateSets.contains(destStateSet)) {
           allStateSets.insert(destStateSet);
           sstc.insert(destStateSet);
+          FA_STAT(statistics.subsetStates++);
         } // if
         fab.addTransition( srcStateSet.stateOf(), tSy,
                           destStateSet.stateOf());
@@ -205,6 +319,557 @@ DFA *NFA::dfaOf() const {
 } // NFA::dfaOf
 
 
+// NFA::dfaOfParallel: parallel subset construction
+//-------------------
+// workers take unprocessed subsets from a shared queue, compute their
+// successors for all symbols and insert them into a concurrent
+// SubsetTable, which assigns ids in the order of insertion, so these
+// ids depend on the scheduling. Therefore the DFA states are renumbered
+// canonically (in BFS order from the start state, symbols in the order
+// of V) and named like in dfaOf, so the result is the same DFA.
+
+struct SubsetQueue {       // shared queue of (id, subset) to process
+  mutex                    mtx;
+  condition_variable       cv;
+  deque<pair<int, Subset>> items;
+  int                      pending = 0; // queued + in process
+}; // SubsetQueue
+
+struct SubsetTransition { int src, symIdx, dest; }; // ids of subsets
+
+
+DFA *NFA::dfaOfParallel(int nThreads) const {
+  return dfaOfParallel(nThreads, false);
+} // NFA::dfaOfParallel
+
+bool NFA::hasEpsOnlyStart() const {
+  StateId start = sIdx.idOf(s1);
+  if (F.contains(s1))
+    return false;
+  for (int a = 0; a < vIdx.size(); a++)
+    if (!table.destsAt(start, a).empty())
+      return false;        // start state has a symbol transition
+  for (StateId s = 0; s < sIdx.size(); s++)
+    for (int a = 0; a <= vIdx.size(); a++) // incl. eps. transitions
+      for (StateId dest: table.destsAt(s, a))
+        if (dest == start)
+          return false;    // start state has an incoming transition
+  return true;
+} // NFA::hasEpsOnlyStart
+
+DTable NFA::subsetTableOf(int nThreads, bool dropEpsOnlyStart,
+                          vector<Subset> &subsets,
+                          vector<char>   &isFinal) const {
+  if (nThreads <= 0)
+    nThreads = max(1, (int)thread::hardware_concurrency());
+  const int nStates  = sIdx.size();
+  const int nSymbols = vIdx.size();
+
+  // 1. parallel construction of all subsets and transitions
+  SubsetTable subsetIds;
+  SubsetQueue queue;
+  Subset startSubset(epsClosures.closureOf(sIdx.idOf(s1)).begin(),
+                     epsClosures.closureOf(sIdx.idOf(s1)).end());
+  if (dropEpsOnlyStart && startSubset.size() > 1 &&
+      hasEpsOnlyStart())   // start state does not ...
+    startSubset.erase(find(startSubset.begin(), startSubset.end(), // ...
+                           sIdx.idOf(s1)));     // ... change the language
+  queue.items.emplace_back(subsetIds.insert(startSubset).first, startSubset);
+  queue.pending = 1;
+
+  vector<vector<SubsetTransition>> transitions(nThreads); // per worker
+  auto worker = [&](vector<SubsetTransition> &myTransitions) {
+    vector<unsigned> mark(nStates, 0); // mark[s] == gen <==> s in dest
+    unsigned gen = 0;
+    Subset dest;
+    for (;;) {
+      unique_lock<mutex> lock(queue.mtx);
+      queue.cv.wait(lock, [&] {
+        return !queue.items.empty() || queue.pending == 0;
+      });
+      if (queue.items.empty())
+        return;            // pending == 0: all subsets processed
+      pair<int, Subset> src = move(queue.items.front());
+      queue.items.pop_front();
+      lock.unlock();
+      for (int a = 0; a < nSymbols; a++) {
+        if (++gen == 0) {  // wrap around, so reset all marks
+          fill(mark.begin(), mark.end(), 0);
+          gen = 1;
+        } // if
+        dest.clear();
+        for (StateId s: src.second)
+          for (StateId d: table.destsAt(s, a))
+            if (mark[d] != gen)
+              for (StateId c: epsClosures.closureOf(d))
+                if (mark[c] != gen) {
+                  mark[c] = gen;
+                  dest.push_back(c);
+                } // if
+        if (dest.empty())
+          continue;        // transition is undefined
+        sort(dest.begin(), dest.end());
+        pair<int, bool> ins = subsetIds.insert(dest);
+        myTransitions.push_back({src.first, a, ins.first});
+        if (ins.second) {  // new subset, so process it later
+          lock_guard<mutex> qLock(queue.mtx);
+          queue.items.emplace_back(ins.first, dest);
+          queue.pending++;
+          queue.cv.notify_one();
+        } // if
+      } // for
+      lock.lock();
+      queue.pending--;
+      if (queue.pending == 0)
+        queue.cv.notify_all();
+    } // for
+  }; // worker
+  vector<thread> workers;
+  for (int i = 0; i < nThreads; i++)
+    workers.emplace_back(worker, ref(transitions[i]));
+  for (thread &t: workers)
+    t.join();
+
+  // 2. canonical renumbering: BFS from start subset (id 0)
+  const int nSubsets = subsetIds.size();
+  vector<int> delta(nSubsets * nSymbols, undefId);
+  for (const vector<SubsetTransition> &ts: transitions)
+    for (const SubsetTransition &t: ts)
+      delta[t.src * nSymbols + t.symIdx] = t.dest;
+  transitions.clear();
+  vector<int> order, canonical(nSubsets, -1); // canonical[id]: new nr.
+  order.reserve(nSubsets);
+  order.push_back(0);
+  canonical[0] = 0;
+  for (size_t i = 0; i < order.size(); i++)
+    for (int a = 0; a < nSymbols; a++) {
+      int dest = delta[order[i] * nSymbols + a];
+      if (dest >= 0 && canonical[dest] < 0) {
+        canonical[dest] = (int)order.size();
+        order.push_back(dest);
+      } // if
+    } // for
+  FA_STAT(statistics.subsetStates += nSubsets);
+
+  // 3. subsets, final states and table in canonical order
+  vector<Subset> subsetsById = subsetIds.takeSubsets();
+  vector<char>   isFinalState(nStates, false);
+  for (const State &f: F)
+    isFinalState[sIdx.idOf(f)] = true;
+  subsets.assign(nSubsets, Subset());
+  isFinal.assign(nSubsets, false);
+  vector<StateId> dests(nSubsets * nSymbols, undefId);
+  for (int c = 0; c < nSubsets; c++) {
+    int id = order[c];
+    for (int a = 0; a < nSymbols; a++) {
+      int dest = delta[id * nSymbols + a];
+      if (dest >= 0)
+        dests[c * nSymbols + a] = canonical[dest];
+    } // for
+    for (StateId s: subsetsById[id])
+      if (isFinalState[s]) {
+        isFinal[c] = true;
+        break;
+      } // if
+    subsets[c].swap(subsetsById[id]);
+  } // for
+  return DTable(nSymbols, move(dests));
+} // NFA::subsetTableOf
+
+DFA *NFA::dfaOfParallel(int nThreads, bool dropEpsOnlyStart) const {
+  TIME_PHASE("NFA::dfaOfParallel");
+  TRACK_ALLOCATIONS("NFA::dfaOfParallel");
+
+  vector<Subset> subsets;
+  vector<char>   isFinal;
+  const DTable table = subsetTableOf(nThreads, dropEpsOnlyStart,
+                                     subsets, isFinal);
+
+  // build DFA with states named like in dfaOf
+  const int nSubsets = table.nrOfStates();
+  vector<State> names(nSubsets);
+  for (int c = 0; c < nSubsets; c++) {
+    StateSet ss;
+    for (StateId s: subsets[c])
+      ss.insert(ss.end(), sIdx.stateAt(s)); // sorted, so O(1)
+    names[c] = ss.stateOf();
+  } // for
+  // built directly as FABuilder does not allow the language {}
+  StateSet S, F;
+  DDelta   delta;
+  for (int c = 0; c < nSubsets; c++) {
+    S.insert(names[c]);
+    for (int a = 0; a < table.nrOfSymbols(); a++) {
+      StateId dest = table.destAt(c, a);
+      if (dest != undefId)
+        delta[names[c]][vIdx.symbolAt(a)] = names[dest];
+    } // for
+    if (isFinal[c])
+      F.insert(names[c]);
+  } // for
+  return new DFA(S, V, names[0], F, delta);
+} // NFA::dfaOfParallel
+
+
+// NFA::renamedMinimalDfaOf: fused pipeline dfaOf -> minimalOf -> renamedOf
+//------------------------
+// subset construction (see subsetTableOf) and partition refinement (see
+// refinedPartitionOf) on integer tables, the blocks are numbered like in
+// renamedOf (BFS from start block, symbols in the order of V)
+
+DFA *NFA::renamedMinimalDfaOf(bool numbered, int nThreads) const {
+  TIME_PHASE("NFA::renamedMinimalDfaOf");
+  TRACK_ALLOCATIONS("NFA::renamedMinimalDfaOf");
+
+  // 1. subset construction and minimization
+  vector<Subset> subsets;
+  vector<char>   isFinal;
+  const DTable table = subsetTableOf(nThreads, false, subsets, isFinal);
+  if (numbered)            // subsets are needed for names only
+    vector<Subset>().swap(subsets);
+  const Partition p = refinedPartitionOf(table, isFinal, nThreads);
+  FA_STAT(statistics.refinementPasses += p.nPasses);
+
+  // 2. number blocks in BFS order, block of first state as representative
+  const int nSymbols = table.nrOfSymbols();
+  vector<StateId> representative(p.nBlocks, undefId);
+  for (StateId s = table.nrOfStates() - 1; s >= 0; s--)
+    representative[p.blockOf[s]] = s;
+  vector<int> order, number(p.nBlocks, -1); // number[block]: BFS nr.
+  order.reserve(p.nBlocks);
+  order.push_back(p.blockOf[0]);
+  number[p.blockOf[0]] = 0;
+  for (size_t i = 0; i < order.size(); i++)
+    for (int a = 0; a < nSymbols; a++) {
+      StateId dest = table.destAt(representative[order[i]], a);
+      if (dest != undefId && number[p.blockOf[dest]] < 0) {
+        number[p.blockOf[dest]] = (int)order.size();
+        order.push_back(p.blockOf[dest]);
+      } // if
+    } // for
+
+  // 3. names: numbers like in renamedOf or like in dfaOf()->minimalOf()
+  vector<State> names(p.nBlocks);
+  if (numbered) {
+    int digits = (int)round(log(order.size()) / log(10) + 0.5);
+    for (int b = 0; b < p.nBlocks; b++) {
+      string nn = to_string(number[b]);
+      names[b] = string(digits - nn.length(), '0') + nn;
+    } // for
+  } else {
+    vector<StateSet> blockSets(p.nBlocks);
+    for (StateId s = 0; s < table.nrOfStates(); s++) {
+      StateSet ss;
+      for (StateId id: subsets[s])
+        ss.insert(ss.end(), sIdx.stateAt(id)); // sorted, so O(1)
+      blockSets[p.blockOf[s]].insert(ss.stateOf());
+    } // for
+    for (int b = 0; b < p.nBlocks; b++)
+      names[b] = blockSets[b].stateOf();
+  } // else
+
+  // 4. build the final DFA directly (FABuilder does not allow {})
+  StateSet S, F;
+  DDelta   delta;
+  for (int b: order) {
+    S.insert(names[b]);
+    for (int a = 0; a < nSymbols; a++) {
+      StateId dest = table.destAt(representative[b], a);
+      if (dest != undefId)
+        delta[names[b]][vIdx.symbolAt(a)] = names[p.blockOf[dest]];
+    } // for
+    if (isFinal[representative[b]])
+      F.insert(names[b]);
+  } // for
+  return new DFA(S, V, names[p.blockOf[0]], F, delta);
+} // NFA::renamedMinimalDfaOf
+
+
+// Language Inclusion (antichains)
+// ------------------
+
+bool included(const NFA &a, const NFA &b, Tape *counterexample) {
+  TIME_PHASE("included");
+
+  // eps. closed successors of Q in nfa for tSy (empty if tSy not in V)
+  auto postOf = [](const NFA &nfa, const Subset &Q, TapeSymbol tSy) {
+    Subset post;
+    int c = nfa.vIdx.indexOf(tSy);
+    if (c < 0)
+      return post;
+    for (StateId s: Q)
+      for (StateId d: nfa.table.destsAt(s, c))
+        for (StateId e: nfa.epsClosures.closureOf(d))
+          post.push_back(e);
+    sort(post.begin(), post.end());
+    post.erase(unique(post.begin(), post.end()), post.end());
+    return post;
+  }; // postOf
+  vector<char> finalA(a.sIdx.size(), false), finalB(b.sIdx.size(), false);
+  for (const State &f: a.F)
+    finalA[a.sIdx.idOf(f)] = true;
+  for (const State &f: b.F)
+    finalB[b.sIdx.idOf(f)] = true;
+  TapeSymbolSet V = a.V;   // symbols not in b.V lead to empty sets in b
+  const SymbolIndex vIdx(V);
+
+  struct Node { StateId p; Subset Q; int from; TapeSymbol tSy; bool alive; };
+  vector<Node>        nodes; // used as queue, kept for counterexamples
+  vector<vector<int>> antichain(a.sIdx.size()); // p -> nodes with p
+  auto add = [&](StateId p, Subset &&Q, int from, TapeSymbol tSy) {
+    vector<int> &ac = antichain[p];
+    for (int i: ac)        // subsumed by a node with smaller set?
+      if (includes(Q.begin(), Q.end(),
+                   nodes[i].Q.begin(), nodes[i].Q.end()))
+        return;
+    size_t k = 0;          // remove nodes subsumed by the new one
+    for (int i: ac)
+      if (includes(nodes[i].Q.begin(), nodes[i].Q.end(), Q.begin(), Q.end()))
+        nodes[i].alive = false;
+      else
+        ac[k++] = i;
+    ac.resize(k);
+    ac.push_back((int)nodes.size());
+    nodes.push_back({p, move(Q), from, tSy, true});
+  }; // add
+
+  const IdSpan startB = b.epsClosures.closureOf(b.sIdx.idOf(b.s1));
+  for (StateId p: a.epsClosures.closureOf(a.sIdx.idOf(a.s1)))
+    add(p, Subset(startB.begin(), startB.end()), -1, eot);
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (!nodes[i].alive)
+      continue;
+    bool acceptedByB = false;
+    for (StateId q: nodes[i].Q)
+      acceptedByB = acceptedByB || finalB[q];
+    if (finalA[nodes[i].p] && !acceptedByB) {
+      if (counterexample != nullptr) {
+        Tape tape;
+        for (int j = (int)i; nodes[j].from >= 0; j = nodes[j].from)
+          tape.push_back(nodes[j].tSy);
+        counterexample->assign(tape.rbegin(), tape.rend());
+      } // if
+      return false;
+    } // if
+    for (int c = 0; c < vIdx.size(); c++) {
+      TapeSymbol tSy = vIdx.symbolAt(c);
+      Subset post = postOf(b, nodes[i].Q, tSy);
+      for (StateId p: postOf(a, Subset(1, nodes[i].p), tSy))
+        add(p, Subset(post), (int)i, tSy);
+    } // for
+  } // for
+  return true;
+} // included
+
+
+// reversal: each transition (src, a) -> dest becomes (dest, a) -> src
+//-----------
+
+NFA *reversedNFAOf(const State &s1, const StateSet &F, const NDelta &delta,
+                   const TapeSymbolSet &V) {
+  // 1. reversed transitions: dest -> (tSy, src)
+  map<State, vector<pair<TapeSymbol, State>>> rev;
+  for (const auto &t: delta.transitions())
+    for (const State &dest: t.dest)
+      rev[dest].emplace_back(t.tSy, t.src);
+
+  // 2. states from which a final state can be reached in the original
+  //    automaton, i.e., reachable from a final state in the reversed one
+  StateSet      coReachable = F;
+  vector<State> toVisit(F.begin(), F.end());
+  while (!toVisit.empty()) {
+    State s = toVisit.back();
+    toVisit.pop_back();
+    for (const auto &p: rev[s])
+      if (!coReachable.contains(p.second)) {
+        coReachable.insert(p.second);
+        toVisit.push_back(p.second);
+      } // if
+  } // while
+  // 3. languages {} and {eps}: one state without transitions, built
+  //    directly as FABuilder does not allow automata without transitions
+  bool hasTransitions = F.size() > 1; // eps. transitions from new start
+  for (const State &s: coReachable)
+    hasTransitions = hasTransitions || !rev[s].empty();
+  if (!coReachable.contains(s1) || !hasTransitions)
+    return new NFA(StateSet(s1), V, s1,
+                   coReachable.contains(s1) ? StateSet(s1) : StateSet(),
+                   NDelta());
+
+  // 4. build reversed automaton
+  FABuilder fab;
+  State start = F.anyElement();
+  if (F.size() > 1) {      // new start state
+    start = "S'";
+    while (coReachable.contains(start))
+      start += "'";
+    for (const State &f: F)
+      fab.addTransition(start, eps, f);
+  } // if
+  fab.setStartState(start);
+  for (const State &dest: coReachable)
+    for (const auto &p: rev[dest])
+      fab.addTransition(dest, p.first, p.second);
+  fab.addFinalState(s1);
+  return fab.buildNFA();
+} // reversedNFAOf
+
+
+NFA *NFA::reversed() const {
+  TIME_PHASE("NFA::reversed");
+  return reversedNFAOf(s1, F, delta, V);
+} // NFA::reversed
+
+
+// NFA::brzozowskiOf (cf. Brzozowski, 1962):
+//------------------
+// determinization of a reversed automaton results in a DFA without
+// equivalent states for the reversed language, so twice gives the
+// minimal DFA (without ever building the unminimized DFA). This requires
+// the final states as start states of the reversed automaton, so the
+// additional start state (see reversedNFAOf) is dropped from the start
+// subset.
+
+bool NFA::hasTrivialLanguage() const {
+  const FAGraph graph = graphOf();
+  const int     n     = sIdx.size();
+  vector<char>    reachable(n, false), productive(n, false);
+  vector<vector<StateId>> preds(n);
+  vector<StateId> stack(1, sIdx.idOf(s1));
+  reachable[stack.back()] = true;
+  while (!stack.empty()) {
+    StateId s = stack.back();
+    stack.pop_back();
+    for (const auto &e: graph[s])
+      if (!reachable[e.second]) {
+        reachable[e.second] = true;
+        stack.push_back(e.second);
+      } // if
+  } // while
+  for (StateId s = 0; s < n; s++)
+    for (const auto &e: graph[s])
+      preds[e.second].push_back(s);
+  for (const State &f: F) {
+    productive[sIdx.idOf(f)] = true;
+    stack.push_back(sIdx.idOf(f));
+  } // for
+  while (!stack.empty()) {
+    StateId s = stack.back();
+    stack.pop_back();
+    for (StateId p: preds[s])
+      if (!productive[p]) {
+        productive[p] = true;
+        stack.push_back(p);
+      } // if
+  } // while
+  for (StateId s = 0; s < n; s++)
+    if (reachable[s])
+      for (const auto &e: graph[s])
+        if (e.first != eps && productive[e.second])
+          return false;    // s -tSy-> dest starts a non-empty tape
+  return true;
+} // NFA::hasTrivialLanguage
+
+DFA *NFA::trivialDfaOf() const {
+  bool acceptsEps = false; // eps-closure of s1 contains a final state
+  for (StateId s: epsClosures.closureOf(sIdx.idOf(s1)))
+    acceptsEps = acceptsEps || F.contains(sIdx.stateAt(s));
+  return DFA::numberedDfaOf(
+           DTable(vIdx.size(), vector<StateId>(vIdx.size(), undefId)),
+           vector<char>(1, acceptsEps), 0, V, false);
+} // NFA::trivialDfaOf
+
+DFA *NFA::brzozowskiOf() const {
+  TIME_PHASE("NFA::brzozowskiOf");
+  if (hasTrivialLanguage())
+    return trivialDfaOf();
+  unique_ptr<NFA> rev1(reversed());
+  unique_ptr<DFA> dfa1(rev1->dfaOfParallel(0, true));
+  rev1.reset();
+  unique_ptr<DFA> renamed1(dfa1->renamedOf()); // short names for 2. pass
+  dfa1.reset();
+  unique_ptr<NFA> rev2(renamed1->reversed());
+  renamed1.reset();
+  return rev2->dfaOfParallel(0, true);
+} // NFA::brzozowskiOf
+
+
+// NFA::minimalDfaOf: Brzozowski tends to be faster for NFAs with a high
+//-----------------  transition density (transitions per state and symbol)
+//                   as subset construction of those often results in
+//                   large DFAs with many equivalent states
+//                   (cf. Tabakov/Vardi, 2005: break even at about 1.5)
+
+DFA *NFA::minimalDfaOf() const {
+  if (hasTrivialLanguage())
+    return trivialDfaOf();
+  long nTransitions = 0;
+  for (StateId s = 0; s < sIdx.size(); s++) {
+    for (int a = 0; a < vIdx.size(); a++)
+      nTransitions += table.destsAt(s, a).size();
+    nTransitions += table.epsDestsAt(s).size();
+  } // for
+  double density = (double)nTransitions / ((double)sIdx.size() * vIdx.size());
+  if (density >= 1.5)
+    return brzozowskiOf();
+  // reversing twice removes states from which no final state can be
+  //   reached, so the DFA has no dead states and its minimal DFA is the
+  //   same as the one of brzozowskiOf (up to the names of the states)
+  unique_ptr<NFA> rev(reversed());
+  unique_ptr<NFA> trimmed(rev->reversed());
+  rev.reset();
+  unique_ptr<DFA> dfa(trimmed->dfaOfParallel());
+  return dfa->minimalOfParallel();
+} // NFA::minimalDfaOf
+
+
+// NFA::epsFreeOf: delta'(s, a) = union of delta(c, a) for c in eps-closure(s)
+//---------------  and s is final <==> eps-closure(s) contains a final state
+
+NFA *NFA::epsFreeOf() const {
+  TIME_PHASE("NFA::epsFreeOf");
+
+  Arena     arena; // for all temporary data, released at once at the end
+  FABuilder fab(arena.resource());
+  const StateId start = sIdx.idOf(s1);
+
+  // only states reachable without epsilon transitions are kept
+  vector<char>    reached(sIdx.size(), false);
+  vector<StateId> stc(1, start); // states to check
+  reached[start] = true;
+  bool hasTransitions = false, hasFinals = false, startIsFinal = false;
+  fab.setStartState(s1);
+  while (!stc.empty()) {
+    StateId src = stc.back();
+    stc.pop_back();
+    for (StateId c: epsClosures.closureOf(src)) {
+      if (F.contains(sIdx.stateAt(c))) {
+        fab.addFinalState(sIdx.stateAt(src));
+        hasFinals    = true;
+        startIsFinal = startIsFinal || src == start;
+      } // if
+      for (int a = 0; a < vIdx.size(); a++)
+        for (StateId dest: table.destsAt(c, a)) {
+          fab.addTransition(sIdx.stateAt(src), vIdx.symbolAt(a),
+                            sIdx.stateAt(dest));
+          hasTransitions = true;
+          if (!reached[dest]) {
+            reached[dest] = true;
+            stc.push_back(dest);
+          } // if
+        } // for
+    } // for
+  } // while
+
+  // languages {} and {eps} (or {} with transitions): one state without
+  //   transitions, built directly as FABuilder does not allow it
+  if (!hasTransitions || !hasFinals)
+    return new NFA(StateSet(s1), V, s1,
+                   startIsFinal ? StateSet(s1) : StateSet(), NDelta());
+  return fab.buildNFA();
+} // NFA::epsFreeOf
+
+
 // end of NFA.cpp
 //======================================================================
 
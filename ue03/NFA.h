@@ -6,9 +6,12 @@
 #ifndef NFA_h
 #define NFA_h
 
+#include <vector>
+
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
+#include "TableStuff.h"
 #include "FA.h"
 
 
@@ -20,6 +23,10 @@ class NFA: public  FA
 
   friend class FABuilder;  // so ::build.. methods can call prot. constr.
 
+  friend bool included(const NFA &a, const NFA &b, Tape *counterexample);
+  friend NFA *reversedNFAOf(const State &s1, const StateSet &F,
+                            const NDelta &delta, const TapeSymbolSet &V);
+
   private:
 
     typedef FA Base;
@@ -30,13 +37,43 @@ class NFA: public  FA
         const NDelta   &delta);
 
     virtual StateSet deltaAt(const State &src, TapeSymbol tSy) const;
+    virtual void appendTransitionsOf(StateId src,
+      std::vector<std::pair<TapeSymbol, StateId>> &transitions) const;
 
     bool accepts2(const State& s, const Tape &tape, int i) const; // uses backtracking
 
+    // true if s1 is not final and has eps. transitions only and no
+    //   incoming transitions, so the start subset does not need s1
+    bool hasEpsOnlyStart() const;
+
+    // true if L(this) is {} or {eps}, i.e., no symbol transition leads
+    //   from a state reachable from s1 to a state that reaches a final
+    //   state, FABuilder cannot build automata without transitions, so
+    //   brzozowskiOf and minimalDfaOf use trivialDfaOf for these
+    bool hasTrivialLanguage() const;
+    DFA *trivialDfaOf() const; // minimal DFA with one state
+    DFA *dfaOfParallel(int nThreads, bool dropEpsOnlyStart) const;
+
+    // integer part of dfaOfParallel: table of the DFA with states in
+    //   canonical order (0 = start), their subsets and final states
+    DTable subsetTableOf(int nThreads, bool dropEpsOnlyStart,
+                         std::vector<Subset> &subsets,
+                         std::vector<char>   &isFinal) const;
+
   public:
 
     const NDelta delta;    // non-deterministic transition function
 
+  private:
+
+    // integer tables, computed once on construction (see TableStuff.h)
+    const StateIndex      sIdx;
+    const SymbolIndex     vIdx;
+    const NTable          table;
+    const EpsClosureTable epsClosures; // used by epsClosureOf
+
+  public:
+
     NFA(const NFA  &nfa) = default;
     NFA(      NFA &&nfa) = default;
 
@@ -45,12 +82,16 @@ class NFA: public  FA
     bool accepts (const Tape &tape) const; // impl. of abstract method
       // calls one of the three accepts methods (1, 2 or 3) below
 
+    const StateIndex &stateIndex() const { // impl. of abstract method
+      return sIdx;
+    } // stateIndex
+
     bool accepts1(const Tape &tape) const; // uses multithreading
 
     bool accepts2(const Tape &tape) const; // uses backtracking
 
-    StateSet epsClosureOf(const State    &src   ) const;
-    StateSet epsClosureOf(const StateSet &srcSet) const;
+    StateSet epsClosureOf(const State    &src   ) const; // both use ...
+    StateSet epsClosureOf(const StateSet &srcSet) const; // ... precomp. closures
 
     StateSet allDestsFor(const StateSet &srcSet, TapeSymbol tSy) const;
 
@@ -58,9 +99,86 @@ class NFA: public  FA
 
     DFA *dfaOf() const;    // transformation: NFA => DFA
 
+    // same DFA as dfaOf, but subset construction with nThreads threads
+    //   (0: one per hardware thread) on the integer tables
+    DFA *dfaOfParallel(int nThreads = 0) const;
+
+    NFA *epsFreeOf() const; // transformation: NFA => NFA without eps. trans.
+
+    // same DFA as dfaOf()->minimalOf()->renamedOf() (numbered == true)
+    //   or as dfaOf()->minimalOf() (numbered == false), but in integer
+    //   form up to the final DFA, so without the intermediate automata
+    DFA *renamedMinimalDfaOf(bool numbered = true, int nThreads = 0) const;
+
+    // NFA for the reversed language, only with states from which a final
+    //   state can be reached, a new start state (with eps. transitions
+    //   to the old final states) if there is more than one final state,
+    //   for the languages {eps} and {} one state without transitions
+    //   (final for {eps}), built directly as FABuilder does not allow it
+    NFA *reversed() const;
+
+    // minimal DFA via Brzozowski: dfaOf(reversed(dfaOf(reversed(nfa))))
+    DFA *brzozowskiOf() const;
+
+    // minimal DFA (without dead states), either via brzozowskiOf or via
+    //   subset construction and partition refinement (dfaOfParallel,
+    //   minimalOfParallel), chosen by the transition density of the NFA
+    DFA *minimalDfaOf() const;
+
+    class Simulator;       // reusable workspace for acceptance, see below
+
 }; // NFA
 
 
+// NFA for the reversed language of an automaton with start state s1,
+//   final states F, transition function delta and tape symbols V (see
+//   NFA::reversed), used for NFA::reversed and DFA::reversed
+NFA *reversedNFAOf(const State &s1, const StateSet &F, const NDelta &delta,
+                   const TapeSymbolSet &V);
+
+// L(a) subset of L(b)? by a forward antichain search over pairs
+//   (state of a, eps. closed set of states of b), where pairs with
+//   larger sets than others for the same state of a are subsumed, so
+//   b is not determinized; if not included and counterexample != nullptr,
+//   *counterexample is set to a tape in L(a) - L(b)
+bool included(const NFA &a, const NFA &b, Tape *counterexample = nullptr);
+
+
+// Objects of class NFA::Simulator trace sets of states like accepts3,
+//   but on the integer tables of the NFA and with buffers preallocated
+//   for |S| states, so accepts does not allocate any memory.
+// A Simulator refers to its NFA, which has to outlive the Simulator,
+//   and is not thread safe, so use one Simulator per thread.
+
+class NFA::Simulator final // no public base class
+        /*OC+*/ : private ObjectCounter<NFA::Simulator> /*+OC*/ {
+
+  private:
+
+    const NFA            &nfa;
+    const StateId         start;
+    std::vector<char>     isFinal; // StateId -> is final state
+    std::vector<StateId>  cur, next; // current and next set of states
+    std::vector<unsigned> mark;    // mark[s] == gen <==> s in next set
+    unsigned              gen;     // generation of current marks
+
+    void nextGeneration();
+    void addClosureOf(StateId s, std::vector<StateId> &ss);
+
+  public:
+
+    explicit Simulator(const NFA &nfa);
+
+    Simulator(const Simulator &sim) = delete;
+    Simulator &operator=(const Simulator &sim) = delete;
+
+    ~Simulator() = default; // no virtual as class is final
+
+    bool accepts(const Tape &tape);
+
+}; // NFA::Simulator
+
+
 #endif
 
 // end of NFA.h
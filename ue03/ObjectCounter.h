@@ -25,6 +25,19 @@
 //     \*OC-   , private ObjectCounter<UDC>   -OC*\ { ... }; // UDC
 // Switching can easily be incorporated via find and replace.
 //
+// For release builds, object counting can be switched off for all classes
+// at once by defining NO_OBJECT_COUNTING (e.g., -DNO_OBJECT_COUNTING or in
+// the preprocessor definitions of the Release configurations): then
+// ObjectCounter<> is an empty class without a vtable, so the empty base
+// optimization removes it completely from objects of the UDCs.
+// Defining NO_OBJECT_LOGGING keeps the counters but drops the object map.
+//
+// Counting is thread safe: counters are sharded per thread and only
+// aggregated for the report, and objects are logged in a map sharded by
+// address (one mutex per shard, memory grows with the live objects only),
+// so counting can stay on in multithreaded programs without serializing
+// the threads.
+//
 // Implementation based on the curiously recurring template pattern (CRTP),
 // see: en.wikipedia.org/wiki/Curiously_recurring_template_pattern.
 //
@@ -36,9 +49,13 @@
 #ifndef ObjectCounter_h
 #define ObjectCounter_h
 
+#include <cstdint>
 #include <cstdlib>
+#include <atomic>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <fstream>
 #include <string>
 #include <stdexcept>
@@ -47,8 +64,10 @@
 #include <utility>
 
 
-// 1. ACTIVATION: activate object counting
+// 1. ACTIVATION: activate object counting (unless switched off for build)
+#ifndef NO_OBJECT_COUNTING
 #define DO_OBJECT_COUNTING
+#endif
 
 
 #ifndef DO_OBJECT_COUNTING // NO OBJECT COUNTING
@@ -63,7 +82,9 @@
 
 
 // 2. LOGGING: additionally activate logging of objects
-#define LOG_OBJECTS         // log objects in a map to report garbage ..
+#ifndef NO_OBJECT_LOGGING
+#define LOG_OBJECTS         // log objects in a sharded map to report garbage ..
+#endif
 #undef LOG_OBJECTS_TO_FILE // ... additionally in file ObjectCounterLog.txt
 
 // 3. GARBAGE: additionally throw an exception on construction of garbage object
@@ -73,6 +94,11 @@
 
 
 #ifdef LOG_OBJECTS_TO_FILE
+static std::mutex &oclogMutex() { // file logging is for debugging only, ...
+  static std::mutex m;            // ... so threads may be serialized
+  return m;
+} // oclogMutex
+
 static std::ofstream &oclog() {
   static std::unique_ptr<std::ofstream> p(
                      new std::ofstream("ObjectCounterLog.csv"));
@@ -112,6 +138,86 @@ static void throw_runtime_error(const std::string msg, const std::string classNa
 } // throw_runtime_error
 
 
+// counters are sharded: each thread increments the counters in "its" shard
+//   only (relaxed atomics, one cache line per shard, so no false sharing),
+//   totals are aggregated over all shards on demand
+
+const int nOCShards = 16;   // number of counter shards per class
+
+static int ocShardIdx() {   // shard index of the calling thread
+  static std::atomic<int> nextIdx(0);
+  thread_local int idx = nextIdx.fetch_add(1, std::memory_order_relaxed) % nOCShards;
+  return idx;
+} // ocShardIdx
+
+struct alignas(64) OCShard { // one shard of counters, aligned to cache line
+  std::atomic<long> nConstr{0}, nDestr{0};
+}; // OCShard
+
+
+#ifdef LOG_OBJECTS
+
+class OCLog final { // log of live objects: address -> nConstr
+  // sharded by address, each shard is a hash map guarded by its own
+  //   mutex, so threads rarely contend and the maps grow on demand only;
+  // erasing really removes an entry, so costs do not grow with the
+  //   nr. of objects that have passed through the log
+
+  public:
+
+    enum Result { ok, duplicate, unknown };
+
+  private:
+
+    struct alignas(64) Shard {
+      std::mutex                                  m;
+      std::unordered_map<std::uintptr_t, long>    live; // address -> nr
+    }; // Shard
+
+    Shard shards[nOCShards];
+
+    Shard &shardOf(std::uintptr_t a) {
+      return shards[(std::size_t)(((a >> 4) * 0x9E3779B97F4A7C15ull) >> 32) % nOCShards];
+    } // shardOf
+
+  public:
+
+    OCLog() = default;
+
+    OCLog(const OCLog  &ocl) = delete;
+    OCLog(      OCLog &&ocl) = delete;
+
+    OCLog &operator=(const OCLog  &ocl) = delete;
+    OCLog &operator=(      OCLog &&ocl) = delete;
+
+    Result insert(void *otc, long nr) {
+      const std::uintptr_t a = (std::uintptr_t)otc;
+      Shard &sh = shardOf(a);
+      std::lock_guard<std::mutex> lock(sh.m);
+      return sh.live.emplace(a, nr).second ? ok : duplicate;
+    } // insert
+
+    Result erase(void *otc) {
+      const std::uintptr_t a = (std::uintptr_t)otc;
+      Shard &sh = shardOf(a);
+      std::lock_guard<std::mutex> lock(sh.m);
+      return sh.live.erase(a) > 0 ? ok : unknown;
+    } // erase
+
+    // to be called when no other threads use the log any more
+    std::map<long, void *> liveObjects() const { // nConstr -> address
+      std::map<long, void *> lo;
+      for (const Shard &sh: shards)
+        for (const auto &e: sh.live)
+          lo[e.second] = (void *)e.first;
+      return lo;
+    } // liveObjects
+
+}; // OCLog
+
+#endif
+
+
 class OCData final { // data for the ObjectCounters: one OCData object per class
 
   private:
@@ -124,17 +230,39 @@ class OCData final { // data for the ObjectCounters: one OCData object per class
       return *p;
     } // ocdm
 
+    static std::mutex &ocdmMutex() { // guards ocdm, used rarely
+      static std::mutex m;
+      return m;
+    } // ocdmMutex
+
     const std::string className;     // format depends on RTTI, roughly "...UDC..."
     const std::string baseClassName; // format depends on RTTI, roughly "...BASE..."
     const std::string demangledClassName;
     const bool hasBaseClass;         // true <==> className =! baseClassName
-    int nConstr, nDestr;             // number of constructions and destructions
+    std::atomic<OCData *> baseOcd;   // OCData of base class, looked up once
+    OCShard shards[nOCShards];       // numbers of constructions and destructions
 #ifdef LOG_OBJECTS
-    std::unordered_map<void *, int> om; // object map: address -> nConstr
-  #ifdef LOG_OBJECTS_TO_FILE
-  #endif
+    std::atomic<long> nLogged;       // nr. of logged constructions so far
+    OCLog om;                        // object map: address -> nConstr
 #endif
 
+    OCData *baseOCData() {
+      OCData *bocd = baseOcd.load(std::memory_order_acquire);
+      if (bocd == nullptr) { // base class' OCData not looked up yet
+        std::lock_guard<std::mutex> lock(ocdmMutex());
+        bocd = ocdm()[baseClassName];
+        baseOcd.store(bocd, std::memory_order_release);
+      } // if
+      return bocd;
+    } // baseOCData
+
+    long total(std::atomic<long> OCShard::*counter) const {
+      long sum = 0;
+      for (const OCShard &s: shards)
+        sum += (s.*counter).load(std::memory_order_relaxed);
+      return sum;
+    } // total
+
   public:
 
     OCData(                  ) = delete;
@@ -147,11 +275,12 @@ class OCData final { // data for the ObjectCounters: one OCData object per class
       baseClassName(baseClassName),
       demangledClassName(demangled(className)),
       hasBaseClass(className != baseClassName),
-      nConstr(0), nDestr(0)
+      baseOcd(nullptr)
 #ifdef LOG_OBJECTS
-      , om()
+      , nLogged(0), om()
 #endif
     {
+      std::lock_guard<std::mutex> lock(ocdmMutex());
       ocdm()[className] = this; // register OCData for className
     } // OCData
 
@@ -159,41 +288,50 @@ class OCData final { // data for the ObjectCounters: one OCData object per class
     OCData &operator=(      OCData &&ocd) = delete;
 
     void countConstr(void *otc) { // object to count
+      const int si = ocShardIdx();
       if (hasBaseClass)
-        ocdm()[baseClassName]->nConstr--;
-      nConstr++;
+        baseOCData()->shards[si].nConstr.fetch_sub(1, std::memory_order_relaxed);
+      shards[si].nConstr.fetch_add(1, std::memory_order_relaxed);
 #ifdef LOG_OBJECTS
+      long nr = nLogged.fetch_add(1, std::memory_order_relaxed) + 1;
   #ifdef LOG_OBJECTS_TO_FILE
-      oclog() << demangledClassName << "; \t+" << nConstr << "; \t" << otc << std::endl;
+      {
+        std::lock_guard<std::mutex> lock(oclogMutex());
+        oclog() << demangledClassName << "; \t+" << nr << "; \t" << otc << std::endl;
+      }
   #endif
   #ifdef EXCEPT_ON_CONSTR_OF_GARBAGE
       if (demangledClassName == DEMANGLED_CLASS_NAME &&
-          nConstr            == CONSTR_NUMBER)
+          nr                 == CONSTR_NUMBER)
         throw_runtime_error("construction of garbage object", demangledClassName);
   #endif
-      auto ir = om.insert(std::make_pair(otc, nConstr));
-      if (!ir.second)       // otc already has been an element of om
+      if (om.insert(otc, nr) == OCLog::duplicate) // otc already has been in om
         throw_runtime_error("re-construction of object", demangledClassName);
 #endif
     } // countConstr
 
     void countDestr(void *otc) {
+      const int si = ocShardIdx();
       if (hasBaseClass)
-        ocdm()[baseClassName]->nDestr--;
-      nDestr++;
+        baseOCData()->shards[si].nDestr.fetch_sub(1, std::memory_order_relaxed);
+      shards[si].nDestr.fetch_add(1, std::memory_order_relaxed);
 #ifdef LOG_OBJECTS
   #ifdef LOG_OBJECTS_TO_FILE
-      oclog() << demangledClassName << "; \t-" << nDestr << "; \t" << otc << std::endl;
+      {
+        std::lock_guard<std::mutex> lock(oclogMutex());
+        oclog() << demangledClassName << "; \t-" << "; \t" << otc << std::endl;
+      }
   #endif
-      auto ec = om.erase(otc);
-      if (ec == 0)          // otc has not been an element of om
+      if (om.erase(otc) == OCLog::unknown) // otc has not been in om
         throw_runtime_error("destruction of unknown object", demangledClassName);
 #endif
     } //countDestr
 
     ~OCData() {  // non virtual as class is final
       static bool firstCallToDestr = true;
-      int nAlive = nConstr - nDestr;
+      long nConstr = total(&OCShard::nConstr),
+           nDestr  = total(&OCShard::nDestr);
+      long nAlive  = nConstr - nDestr;
       if (!std::cout.good()) // sorry, std::cout is not available any more
         return;
       if (firstCallToDestr) {
@@ -213,11 +351,8 @@ class OCData final { // data for the ObjectCounters: one OCData object per class
       else { // nAlive > 0
          std::cout << " -> GARBAGE!" << std::endl;
 #ifdef LOG_OBJECTS
-        std::unordered_map<int, void *> iom; // inverted om: nConstr -> address
-        for (const auto &e: om)
-          iom[e.second] = e.first;
         int i = 1;
-        for (const auto &e: iom)
+        for (const auto &e: om.liveObjects())
           std::cout << "  " << i++ << ". "
                     << "constrNr = "   << e.first
                     << ", address = "  << e.second << std::endl;
@@ -234,7 +369,7 @@ class ObjectCounter { //   ... privately derived from ObjectCounter ...
 
   private:
 
-    static OCData &ocd() {
+    static OCData &ocd() {  // initialization of local statics is thread safe
       static std::unique_ptr<OCData> p(
                          new OCData(std::string(typeid(UDC ).name()),
                                     std::string(typeid(BASE).name())));
@@ -258,7 +393,9 @@ class ObjectCounter { //   ... privately derived from ObjectCounter ...
     ObjectCounter &operator=(const ObjectCounter  &/*oc*/) = default;
     ObjectCounter &operator=(      ObjectCounter &&/*oc*/) = default;
 
-    virtual ~ObjectCounter() {
+    // protected and non-virtual (no vtable) as ObjectCounter<> is
+    //   a private base class that is never deleted on its own
+    ~ObjectCounter() {
       ocd().countDestr(this);
     } // ~ObjectCounter
 
@@ -0,0 +1,128 @@
+// PerfCounters.cpp:                                           HDO, 2021
+// ----------------
+// PerfCounters reads hardware performance counters (instructions,
+// cycles, cache misses and branch mispredictions) of the calling thread
+// for a measured region between start() and stop(), e.g., for the
+// benchmark harness (see Benchmark.h).
+// Only available on Linux (via perf_event_open). Where counters are
+// not available (other OS, no permission, no PMU in a virtual machine)
+// available() is false, reason() tells why and stop() returns an
+// invalid PerfSample, so callers can simply omit the counters.
+//======================================================================
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+
+#include "PerfCounters.h"
+
+
+#ifdef __linux__
+
+static int openCounter(uint64_t config, int groupFd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = config;
+  attr.disabled       = (groupFd == -1) ? 1 : 0; // leader starts disabled
+  attr.exclude_kernel = 1;  // allowed with perf_event_paranoid <= 2
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP;
+  return (int)syscall(__NR_perf_event_open, &attr,
+                      0 /*this thread*/, -1 /*any cpu*/, groupFd, 0);
+} // openCounter
+
+#endif
+
+
+// --- implementation of class PerfCounters ---
+
+PerfCounters::PerfCounters() {
+  for (int i = 0; i < nCounters; i++)
+    fds[i] = -1;
+#ifdef __linux__
+  const uint64_t configs[nCounters] = {
+    PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+  for (int i = 0; i < nCounters; i++) {
+    fds[i] = openCounter(configs[i], fds[0]);
+    if (fds[i] == -1) {
+      why = string("perf_event_open failed: ") + strerror(errno);
+      if (errno == EACCES || errno == EPERM)
+        why += " (see /proc/sys/kernel/perf_event_paranoid)";
+      else if (errno == ENOENT || errno == EOPNOTSUPP)
+        why += " (no hardware counters, e.g., in a virtual machine)";
+      for (int j = 0; j < i; j++) {
+        close(fds[j]);
+        fds[j] = -1;
+      } // for
+      return;
+    } // if
+  } // for
+#else
+  why = "hardware counters only available on Linux";
+#endif
+} // PerfCounters::PerfCounters
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int i = nCounters - 1; i >= 0; i--)
+    if (fds[i] != -1)
+      close(fds[i]);
+#endif
+} // PerfCounters::~PerfCounters
+
+
+bool PerfCounters::available() const {
+  return fds[0] != -1;
+} // PerfCounters::available
+
+string PerfCounters::reason() const {
+  return why;
+} // PerfCounters::reason
+
+
+void PerfCounters::start() {
+#ifdef __linux__
+  if (!available())
+    return;
+  ioctl(fds[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+  ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+} // PerfCounters::start
+
+PerfSample PerfCounters::stop() {
+  PerfSample ps = {false, 0, 0, 0, 0};
+#ifdef __linux__
+  if (!available())
+    return ps;
+  ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  struct {
+    uint64_t nr;           // nr. of values, due to PERF_FORMAT_GROUP
+    uint64_t values[nCounters];
+  } data;
+  if (read(fds[0], &data, sizeof(data)) != (ssize_t)sizeof(data) ||
+      data.nr != nCounters)
+    return ps;
+  ps.valid        = true;
+  ps.instructions = (long long)data.values[0];
+  ps.cycles       = (long long)data.values[1];
+  ps.cacheMisses  = (long long)data.values[2];
+  ps.branchMisses = (long long)data.values[3];
+#endif
+  return ps;
+} // PerfCounters::stop
+
+
+// end of PerfCounters.cpp
+//======================================================================
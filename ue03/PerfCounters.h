@@ -0,0 +1,61 @@
+// PerfCounters.h:                                             HDO, 2021
+// --------------
+// PerfCounters reads hardware performance counters (instructions,
+// cycles, cache misses and branch mispredictions) of the calling thread
+// for a measured region between start() and stop(), e.g., for the
+// benchmark harness (see Benchmark.h).
+// Only available on Linux (via perf_event_open). Where counters are
+// not available (other OS, no permission, no PMU in a virtual machine)
+// available() is false, reason() tells why and stop() returns an
+// invalid PerfSample, so callers can simply omit the counters.
+//======================================================================
+
+#ifndef PerfCounters_h
+#define PerfCounters_h
+
+#include <string>
+
+#include "ObjectCounter.h"
+
+
+struct PerfSample {
+  bool      valid;         // false: no counters available
+  long long instructions;
+  long long cycles;
+  long long cacheMisses;
+  long long branchMisses;
+}; // PerfSample
+
+
+class PerfCounters final // no public base class
+          /*OC+*/ : private ObjectCounter<PerfCounters> /*+OC*/ {
+
+  private:
+
+    static const int nCounters = 4; // in the order of PerfSample
+
+    int         fds[nCounters];     // file descriptors, fds[0] is leader
+    std::string why;                // reason if not available
+
+  public:
+
+    PerfCounters();  // opens the counters, never throws
+
+    PerfCounters(const PerfCounters &pc) = delete;
+    PerfCounters &operator=(const PerfCounters &pc) = delete;
+
+    ~PerfCounters(); // closes the counters
+
+    bool        available() const;
+    std::string reason()    const; // empty if available
+
+    void       start();  // resets and enables all counters
+    PerfSample stop();   // disables all counters and reads them
+
+}; // PerfCounters
+
+
+#endif
+
+// end of PerfCounters.h
+//======================================================================
@@ -0,0 +1,156 @@
+// SelfCheck.cpp:                                              HDO, 2021
+// --------------
+// Deterministic self-check for the transformations of NFAs into (minimal)
+// DFAs, started via
+//   ue03 -check
+// For random NFAs from FAGenerator (fixed seeds) and for the languages
+// {} and {eps} it compares the DFAs of brzozowskiOf, minimalDfaOf,
+// renamedMinimalDfaOf, dfaOfParallel, minimalOfParallel and epsFreeOf
+// with the reference dfaOf()->minimalOf() by equivalent and prints
+// a counterexample for each mismatch. As dfaOf and minimalOf build via
+// FABuilder, which rejects automata without final states, the reference
+// for {} is the DFA built directly and random NFAs for {} are skipped.
+//======================================================================
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "FAGenerator.h"
+#include "SelfCheck.h"
+
+
+// transformation under test: DFA for NFA nfa, dfa is nfa.dfaOf()
+struct Candidate {
+  const char *name;
+  function<DFA *(const NFA &nfa, const DFA &dfa)> dfaOf;
+}; // Candidate
+
+static const vector<Candidate> candidates = {
+  {"NFA::brzozowskiOf",
+    [](const NFA &nfa, const DFA &)    { return nfa.brzozowskiOf(); }},
+  {"NFA::minimalDfaOf",
+    [](const NFA &nfa, const DFA &)    { return nfa.minimalDfaOf(); }},
+  {"NFA::renamedMinimalDfaOf",
+    [](const NFA &nfa, const DFA &)    { return nfa.renamedMinimalDfaOf(true, 2); }},
+  {"NFA::dfaOfParallel",
+    [](const NFA &nfa, const DFA &)    { return nfa.dfaOfParallel(2); }},
+  {"DFA::minimalOfParallel",
+    [](const NFA &,    const DFA &dfa) { return dfa.minimalOfParallel(2); }},
+  {"NFA::epsFreeOf",      // dfaOf does not allow its NFA without trans.
+    [](const NFA &nfa, const DFA &) {
+      NFA *epsFree = nfa.epsFreeOf();
+      DFA *dfa = epsFree->dfaOfParallel(1);
+      delete epsFree;
+      return dfa;
+    }},
+}; // candidates
+
+
+// automata for the languages {eps} and {} that FABuilder accepts (needs
+//   a transition and a final state): only unproductive or unreachable
+//   parts besides the start state
+static FABuilder *epsBuilder(bool viaEpsTransition) {
+  FABuilder *fab = new FABuilder();
+  fab->setStartState("S").addTransition("S", 'a', "T");
+  if (viaEpsTransition)
+    fab->addTransition("S", eps, "U").addFinalState("U");
+  else
+    fab->addFinalState("S");
+  return fab;
+} // epsBuilder
+
+static FABuilder *emptyBuilder() {
+  FABuilder *fab = new FABuilder();
+  fab->setStartState("S").addTransition("S", 'a', "S").
+       addTransition("U", 'a', "U").addFinalState("U");
+  return fab;
+} // emptyBuilder
+
+
+// compares all candidates for nfa with the reference ref, dfa is
+//   nfa.dfaOf() or another DFA for L(nfa), returns the number of mismatches
+static int checkAll(const string &name, const NFA &nfa,
+                    const DFA &dfa, const DFA &ref) {
+  int nMismatches = 0;
+  for (const Candidate &c: candidates) {
+    DFA *result = nullptr;
+    try {
+      result = c.dfaOf(nfa, dfa);
+    } catch (const exception &e) {
+      cout << "MISMATCH: " << c.name << " for " << name <<
+              " throws: " << e.what() << endl;
+      nMismatches++;
+      continue;
+    } // catch
+    Tape counterexample;
+    if (!equivalent(ref, *result, &counterexample)) {
+      cout << "MISMATCH: " << c.name << " for " << name <<
+              ", counterexample: \"" << counterexample << "\"" << endl;
+      nMismatches++;
+    } // if
+    delete result;
+  } // for
+  return nMismatches;
+} // checkAll
+
+
+int runSelfCheck() {
+  int nNFAs = 0, nSkipped = 0, nMismatches = 0;
+
+  for (int i = 0; i < 3; i++) { // {eps}, {eps} via eps. transition, {}
+    const string name = i == 0 ? "{eps}" : i == 1 ? "{eps} via eps" : "{}";
+    FABuilder *fab = i < 2 ? epsBuilder(i == 1) : emptyBuilder();
+    NFA *nfa = fab->buildNFA();
+    DFA *dfa = i < 2 ? nfa->dfaOf()    : fab->buildDFA();
+    DFA *ref = i < 2 ? dfa->minimalOf() : fab->buildDFA();
+    nMismatches += checkAll(name, *nfa, *dfa, *ref);
+    nNFAs++;
+    delete ref;
+    delete dfa;
+    delete nfa;
+    delete fab;
+  } // for
+
+  // small NFAs only as minimalOf is in O(|S|^2)
+  for (unsigned seed = 0; seed < 500; seed++) {
+    FAGenerator g(seed);
+    g.setNrOfStates(1 + seed % 8).setAlphabetSize(1 + seed % 3).
+      setDensity(0.1 + (seed % 5) * 0.2).setNondeterminism(1 + seed % 3).
+      setEpsDensity((seed % 4) * 0.15).setFinalRatio((seed % 3) * 0.25);
+    NFA *nfa = nullptr;
+    DFA *dfa = nullptr, *ref = nullptr;
+    try {
+      nfa = FABuilder(g.nfaText().c_str()).buildNFA();
+      dfa = nfa->dfaOf();
+      ref = dfa->minimalOf();
+    } catch (const exception &) { // without transitions or reachable finals
+      delete dfa;
+      delete nfa;
+      nSkipped++;
+      continue;
+    } // catch
+    nMismatches +=
+      checkAll("FAGenerator seed " + to_string(seed), *nfa, *dfa, *ref);
+    nNFAs++;
+    delete ref;
+    delete dfa;
+    delete nfa;
+  } // for
+
+  cout << "self-check: " << nNFAs << " NFAs (" << nSkipped << " skipped), " <<
+          candidates.size() << " transformations each, " <<
+          nMismatches << " mismatches" << endl;
+  return nMismatches;
+} // runSelfCheck
+
+
+// end of SelfCheck.cpp
+//======================================================================
@@ -0,0 +1,23 @@
+// SelfCheck.h:                                                HDO, 2021
+// ------------
+// Deterministic self-check for the transformations of NFAs into (minimal)
+// DFAs, started via
+//   ue03 -check
+// For random NFAs from FAGenerator (fixed seeds) and for the languages
+// {} and {eps} it compares the DFAs of brzozowskiOf, minimalDfaOf,
+// renamedMinimalDfaOf, dfaOfParallel, minimalOfParallel and epsFreeOf
+// with the reference dfaOf()->minimalOf() by equivalent and prints
+// a counterexample for each mismatch.
+//======================================================================
+
+#ifndef SelfCheck_h
+#define SelfCheck_h
+
+
+int runSelfCheck(); // returns the number of mismatches
+
+
+#endif
+
+// end of SelfCheck.h
+//======================================================================
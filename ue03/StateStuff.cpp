@@ -11,6 +11,7 @@
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 using namespace std;
 
@@ -48,6 +49,19 @@ State    stateOf   (const StateSet &ss) {
 
 // --- implementation of class StateSet ---
 
+StateSet::StateSet(const allocator_type &a)
+: Base(a) {
+} // StateSet::StateSet
+
+StateSet::StateSet(const StateSet &ss, const allocator_type &a)
+: Base(ss, a) {
+} // StateSet::StateSet
+
+StateSet::StateSet(StateSet &&ss, const allocator_type &a)
+: Base(std::move(ss), a) {
+} // StateSet::StateSet
+
+
 StateSet::StateSet(const State &s) {
   Base::insert(s);
 } // StateSet::StateSet
@@ -130,6 +144,19 @@ ostream &operator<<(ostream &os, const StateSet &ss) {
 
 // --- implementation of class SetOfStateSets ---
 
+SetOfStateSets::SetOfStateSets(const allocator_type &a)
+: Base(a) {
+} // SetOfStateSets::SetOfStateSets
+
+SetOfStateSets::SetOfStateSets(const SetOfStateSets &soss, const allocator_type &a)
+: Base(soss, a) {
+} // SetOfStateSets::SetOfStateSets
+
+SetOfStateSets::SetOfStateSets(SetOfStateSets &&soss, const allocator_type &a)
+: Base(std::move(soss), a) {
+} // SetOfStateSets::SetOfStateSets
+
+
 SetOfStateSets::SetOfStateSets(const StateSet &ss) {
   insert(ss);
 } // SetOfStateSets
@@ -3,6 +3,9 @@
 // State, an alias for std::string represents the state of an automaton,
 //   so std::string, char[] and char* are valid state(name)s.
 // StateSet represents a set of States.
+// StateSet and SetOfStateSets are based on std::pmr::sets, so they can
+//   be allocated in an Arena (see Arena.h), copies of them are allocated
+//   with the default resource again (as std::pmr containers do).
 //======================================================================
 
 #ifndef StateStuff_h
@@ -10,6 +13,7 @@
 
 #include <initializer_list>
 #include <iosfwd>
+#include <memory_resource>
 #include <set>
 #include <string>
 
@@ -30,10 +34,10 @@ StateSet stateSetOf(const State    &s ); //  "s"       -> {"s"}
 State    stateOf   (const StateSet &ss); // {"s", ...} -> "s+..."
 
 
-class StateSet: public  std::set<State>  // equivalent to std::set<string>
+class StateSet: public  std::pmr::set<State>  // like std::set<string>
       /*OC+*/ , private ObjectCounter<StateSet> /*+OC*/ {
 
-    typedef std::set<State> Base;
+    typedef std::pmr::set<State> Base;
 
   public:
 
@@ -41,6 +45,11 @@ class StateSet: public  std::set<State>  // equivalent to std::set<string>
     StateSet(const StateSet  &ss) = default;
     StateSet(      StateSet &&ss) = default;
 
+    // allocator-extended constructors, e.g., for StateSets in an Arena
+    explicit StateSet(const allocator_type &a);
+    StateSet(const StateSet  &ss, const allocator_type &a);
+    StateSet(      StateSet &&ss, const allocator_type &a);
+
     StateSet(const State &s); // s -> {s}
 
     StateSet(std::initializer_list<State> il);
@@ -72,10 +81,10 @@ StateSet operator-(const StateSet &ss1, const StateSet &ss2); // difference
 std::ostream &operator<<(std::ostream &os, const StateSet &ss);
 
 
-class SetOfStateSets: public  std::set<StateSet>
+class SetOfStateSets: public  std::pmr::set<StateSet>
             /*OC+*/ , private ObjectCounter<SetOfStateSets> /*+OC*/ {
 
-    typedef std::set<StateSet> Base;
+    typedef std::pmr::set<StateSet> Base;
 
   public:
 
@@ -83,6 +92,11 @@ class SetOfStateSets: public  std::set<StateSet>
     SetOfStateSets(const SetOfStateSets  &soss) = default;
     SetOfStateSets(      SetOfStateSets &&soss) = default;
 
+    // allocator-extended constructors, e.g., for SetOfStateSets in an Arena
+    explicit SetOfStateSets(const allocator_type &a);
+    SetOfStateSets(const SetOfStateSets  &soss, const allocator_type &a);
+    SetOfStateSets(      SetOfStateSets &&soss, const allocator_type &a);
+
     SetOfStateSets(const StateSet &ss);
 
     SetOfStateSets &operator=(const SetOfStateSets  &soss) = default;
@@ -0,0 +1,303 @@
+// TableStuff.cpp:                                             HDO, 2021
+// --------------
+// Integer-based tables for the fast execution of finite automata:
+// * StateIndex  maps the States of an automaton to StateIds 0, 1, ...
+//               (in the order of the StateSet) and vice versa,
+// * SymbolIndex maps the TapeSymbols to dense indices 0, 1, ... and
+// * NTable      is a non-deterministic transition function, stored as
+//               compressed rows of StateIds, one row per (state, symbol)
+//               and an extra row per state for the epsilon transitions.
+// * DTable      is a deterministic transition function, stored as a
+//               dense matrix of StateIds (undefId for undefined).
+// * EpsClosureTable holds the precomputed epsilon closure of each state
+//               as a sorted row of StateIds.
+// * SubsetTable maps subsets of StateIds (sorted rows) to dense ids,
+//               concurrently usable by many threads (e.g., in parallel
+//               subset construction).
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+#include "TableStuff.h"
+
+
+// --- implementation of class StateIndex ---
+
+StateIndex::StateIndex(const StateSet &S)
+: states(S.begin(), S.end()) {
+  ids.reserve(states.size());
+  for (StateId id = 0; id < (StateId)states.size(); id++)
+    ids[states[id]] = id;
+} // StateIndex::StateIndex
+
+
+StateId StateIndex::idOf(const State &s) const {
+  auto it = ids.find(s);
+  return it != ids.end() ? it->second : undefId;
+} // StateIndex::idOf
+
+
+// --- implementation of class SymbolIndex ---
+
+SymbolIndex::SymbolIndex() {
+  for (int &i: idx)
+    i = -1;
+} // SymbolIndex::SymbolIndex
+
+SymbolIndex::SymbolIndex(const TapeSymbolSet &V)
+: SymbolIndex() {
+  for (TapeSymbol tSy: V) {
+    idx[(unsigned char)tSy] = (int)symbols.size();
+    symbols.push_back(tSy);
+  } // for
+} // SymbolIndex::SymbolIndex
+
+
+// --- implementation of class NTable ---
+
+NTable::NTable(const StateIndex &sIdx, const SymbolIndex &vIdx,
+               const NDelta &delta)
+: nSymbols(vIdx.size()) {
+  rowStart.reserve(sIdx.size() * (nSymbols + 1) + 1);
+  for (StateId src = 0; src < sIdx.size(); src++) {
+    const auto &row = delta[sIdx.stateAt(src)];
+    for (int a = 0; a <= nSymbols; a++) {
+      rowStart.push_back((int)dests.size());
+      TapeSymbol tSy = (a < nSymbols) ? vIdx.symbolAt(a) : eps;
+      for (const State &dest: row[tSy]) {
+        StateId destId = sIdx.idOf(dest);
+        if (destId == undefId)
+          throw invalid_argument("dest. state " + dest + " is not in S");
+        dests.push_back(destId);
+      } // for
+    } // for
+  } // for
+  rowStart.push_back((int)dests.size());
+} // NTable::NTable
+
+
+// --- implementation of class DTable ---
+
+DTable::DTable(const StateIndex &sIdx, const SymbolIndex &vIdx,
+               const DDelta &delta)
+: nSymbols(vIdx.size()), dests(sIdx.size() * vIdx.size(), undefId) {
+  for (StateId src = 0; src < sIdx.size(); src++) {
+    const auto &row = delta[sIdx.stateAt(src)];
+    for (int a = 0; a < nSymbols; a++) {
+      const State &dest = row[vIdx.symbolAt(a)];
+      if (!defined(dest))
+        continue;
+      StateId destId = sIdx.idOf(dest);
+      if (destId == undefId)
+        throw invalid_argument("dest. state " + dest + " is not in S");
+      dests[src * nSymbols + a] = destId;
+    } // for
+  } // for
+} // DTable::DTable
+
+
+DTable::DTable(int nSymbols, vector<StateId> &&dests)
+: nSymbols(nSymbols), dests(move(dests)) {
+} // DTable::DTable
+
+
+// --- Moore-style partition refinement ---
+
+// signatures (and their hashes) are computed in parallel, the new block
+//   numbers sequentially in the order of the states, so the result does
+//   not depend on the scheduling, the rounds stop when no block is split
+Partition refinedPartitionOf(const DTable &table,
+                             const vector<char> &isFinal, int nThreads) {
+  if (nThreads <= 0)
+    nThreads = max(1, (int)thread::hardware_concurrency());
+  const int n      = table.nrOfStates();
+  const int m      = table.nrOfSymbols();
+  const int sigLen = m + 1;
+
+  // 1. initial partition: final and non-final states
+  Partition p = {vector<int>(n, 0), 1, 0};
+  for (StateId s = 0; s < n; s++)  // block 0 for the kind of state 0
+    if (isFinal[s] != isFinal[0]) {
+      p.blockOf[s] = 1;
+      p.nBlocks    = 2;
+    } // if
+
+  // 2. refinement rounds
+  vector<int>    sigs(n * sigLen);
+  vector<size_t> hashes(n);
+  vector<int>    slots;    // open addressing: slot -> state or -1
+  vector<int>    newBlockOf(n);
+  size_t nSlots = 1;
+  while (nSlots < 2 * (size_t)n)
+    nSlots *= 2;
+  for (;;) {
+    p.nPasses++;
+    parallelFor(n, nThreads, [&](int from, int to) {
+      for (int s = from; s < to; s++) {
+        int *sig = &sigs[s * sigLen];
+        sig[0] = p.blockOf[s];
+        for (int a = 0; a < m; a++) {
+          StateId dest = table.destAt(s, a);
+          sig[a + 1] = (dest == undefId) ? -1 : p.blockOf[dest];
+        } // for
+        size_t h = 14695981039346656037ull; // FNV-1a
+        for (int k = 0; k < sigLen; k++) {
+          h ^= (size_t)(unsigned)sig[k];
+          h *= 1099511628211ull;
+        } // for
+        hashes[s] = h;
+      } // for
+    }); // parallelFor
+    slots.assign(nSlots, -1);
+    int nNewBlocks = 0;
+    for (int s = 0; s < n; s++) {
+      size_t i = hashes[s] & (nSlots - 1);
+      for (;;) {
+        int r = slots[i];  // representative of a block
+        if (r < 0) {       // new signature, so new block
+          slots[i] = s;
+          newBlockOf[s] = nNewBlocks++;
+          break;
+        } else if (hashes[r] == hashes[s] &&
+                   equal(&sigs[r * sigLen], &sigs[r * sigLen] + sigLen,
+                         &sigs[s * sigLen])) {
+          newBlockOf[s] = newBlockOf[r];
+          break;
+        } // else
+        i = (i + 1) & (nSlots - 1);
+      } // for
+    } // for
+    p.blockOf.swap(newBlockOf);
+    if (nNewBlocks == p.nBlocks)
+      break;               // stable, no block has been split
+    p.nBlocks = nNewBlocks;
+  } // for
+  return p;
+} // refinedPartitionOf
+
+
+// --- implementation of class EpsClosureTable ---
+
+EpsClosureTable::EpsClosureTable(const NTable &table, int nStates)
+: sccOf(nStates, -1) {
+  // Tarjan's algorithm, iterative to avoid deep recursions
+  vector<int>     index(nStates, -1), low(nStates, 0);
+  vector<char>    onStack(nStates, false);
+  vector<StateId> stack;                // Tarjan's stack of states
+  vector<pair<StateId, int>> calls;     // (state, index of next eps. edge)
+  vector<int>     mark(nStates, -1);    // mark[s] == r <==> s in row r
+  vector<StateId> row;                  // closure of current SCC
+  int nextIndex = 0, nSccs = 0;
+  rowStart.push_back(0);
+  for (StateId root = 0; root < nStates; root++) {
+    if (index[root] >= 0)
+      continue;            // already visited
+    index[root] = low[root] = nextIndex++;
+    stack.push_back(root);
+    onStack[root] = true;
+    calls.push_back(make_pair(root, 0));
+    while (!calls.empty()) {
+      StateId v = calls.back().first;
+      IdSpan  epsDests = table.epsDestsAt(v);
+      if (calls.back().second < epsDests.size()) { // next edge v -> w
+        StateId w = epsDests.begin()[calls.back().second++];
+        if (index[w] < 0) {        // w not visited yet, so "call" w
+          index[w] = low[w] = nextIndex++;
+          stack.push_back(w);
+          onStack[w] = true;
+          calls.push_back(make_pair(w, 0));
+        } else if (onStack[w])     // w in current SCC
+          low[v] = min(low[v], index[w]);
+        continue;
+      } // if
+      calls.pop_back();    // "return" from v
+      if (!calls.empty()) {
+        StateId u = calls.back().first;
+        low[u] = min(low[u], low[v]);
+      } // if
+      if (low[v] != index[v])
+        continue;          // v is not the root of an SCC
+      // pop SCC of v, its successor SCCs have been completed before
+      int r = nSccs++;
+      row.clear();
+      size_t first = stack.size();
+      do {
+        first--;
+        StateId w = stack[first];
+        onStack[w] = false;
+        sccOf[w]   = r;
+        mark[w]    = r;
+        row.push_back(w);
+      } while (stack[first] != v);
+      for (size_t i = first; i < stack.size(); i++)
+        for (StateId w: table.epsDestsAt(stack[i]))
+          if (sccOf[w] != r)       // successor SCC, its closure is known
+            for (StateId x: closureOf(w))
+              if (mark[x] != r) {
+                mark[x] = r;
+                row.push_back(x);
+              } // if
+      stack.resize(first);
+      sort(row.begin(), row.end());
+      dests.insert(dests.end(), row.begin(), row.end());
+      rowStart.push_back((int)dests.size());
+    } // while
+  } // for
+} // EpsClosureTable::EpsClosureTable
+
+
+// --- implementation of class SubsetTable ---
+
+size_t SubsetHash::operator()(const Subset &ss) const {
+  size_t h = 14695981039346656037ull; // FNV-1a over all StateIds
+  for (StateId id: ss) {
+    h ^= (size_t)id;
+    h *= 1099511628211ull;
+  } // for
+  return h;
+} // SubsetHash::operator()
+
+
+SubsetTable::SubsetTable()
+: nextId(0) {
+} // SubsetTable::SubsetTable
+
+
+pair<int, bool> SubsetTable::insert(const Subset &ss) {
+  size_t h = SubsetHash()(ss);
+  Shard &shard = shards[(h >> 32 ^ h) % nShards];
+  lock_guard<mutex> lock(shard.mtx);
+  auto it = shard.ids.find(ss);
+  if (it != shard.ids.end())
+    return make_pair(it->second, false);
+  int id = nextId.fetch_add(1);
+  shard.ids.emplace(ss, id);
+  return make_pair(id, true);
+} // SubsetTable::insert
+
+
+int SubsetTable::size() const {
+  return nextId.load();
+} // SubsetTable::size
+
+
+vector<Subset> SubsetTable::takeSubsets() {
+  vector<Subset> result(size());
+  for (Shard &shard: shards) {
+    while (!shard.ids.empty()) {
+      auto node = shard.ids.extract(shard.ids.begin()); // key is movable
+      result[node.mapped()] = move(node.key());
+    } // while
+  } // for
+  nextId = 0;
+  return result;
+} // SubsetTable::takeSubsets
+
+
+// end of TableStuff.cpp
+//======================================================================
@@ -0,0 +1,276 @@
+// TableStuff.h:                                               HDO, 2021
+// ------------
+// Integer-based tables for the fast execution of finite automata:
+// * StateIndex  maps the States of an automaton to StateIds 0, 1, ...
+//               (in the order of the StateSet) and vice versa,
+// * SymbolIndex maps the TapeSymbols to dense indices 0, 1, ... and
+// * NTable      is a non-deterministic transition function, stored as
+//               compressed rows of StateIds, one row per (state, symbol)
+//               and an extra row per state for the epsilon transitions.
+// * DTable      is a deterministic transition function, stored as a
+//               dense matrix of StateIds (undefId for undefined).
+// * EpsClosureTable holds the precomputed epsilon closure of each state
+//               as a sorted row of StateIds.
+// * SubsetTable maps subsets of StateIds (sorted rows) to dense ids,
+//               concurrently usable by many threads (e.g., in parallel
+//               subset construction).
+//======================================================================
+
+#ifndef TableStuff_h
+#define TableStuff_h
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DeltaStuff.h"
+
+
+typedef int StateId;            // index of a State in a StateIndex
+constexpr StateId undefId = -1; // for the undefined state
+
+
+class IdSpan { // read-only view on a (compressed) row of StateIds
+
+  private:
+
+    const StateId *b, *e;
+
+  public:
+
+    IdSpan(const StateId *b, const StateId *e)
+    : b(b), e(e) {
+    } // IdSpan
+
+    const StateId *begin() const { return b; }
+    const StateId *end()   const { return e; }
+
+    int  size()  const { return (int)(e - b); }
+    bool empty() const { return b == e; }
+
+}; // IdSpan
+
+
+class StateIndex final // no public base class
+           /*OC+*/ : private ObjectCounter<StateIndex> /*+OC*/ {
+
+  private:
+
+    std::vector<State>                  states; // StateId -> State
+    std::unordered_map<State, StateId>  ids;    // State   -> StateId
+
+  public:
+
+    StateIndex() = default;
+    explicit StateIndex(const StateSet &S);
+
+    int size() const {
+      return (int)states.size();
+    } // size
+
+    StateId idOf(const State &s) const; // undefId for unknown State s
+
+    const State &stateAt(StateId id) const {
+      return states[id];
+    } // stateAt
+
+}; // StateIndex
+
+
+class SymbolIndex final // no public base class
+            /*OC+*/ : private ObjectCounter<SymbolIndex> /*+OC*/ {
+
+  private:
+
+    int                     idx[256]; // TapeSymbol -> index, -1 if not in V
+    std::vector<TapeSymbol> symbols;  // index -> TapeSymbol
+
+  public:
+
+    SymbolIndex();
+    explicit SymbolIndex(const TapeSymbolSet &V);
+
+    int size() const {
+      return (int)symbols.size();
+    } // size
+
+    int indexOf(TapeSymbol tSy) const { // -1 for tSy not in V (e.g., eps)
+      return idx[(unsigned char)tSy];
+    } // indexOf
+
+    TapeSymbol symbolAt(int i) const {
+      return symbols[i];
+    } // symbolAt
+
+}; // SymbolIndex
+
+
+class NTable final // no public base class
+       /*OC+*/ : private ObjectCounter<NTable> /*+OC*/ {
+
+  private:
+
+    int                  nSymbols; // columns per state, plus one for eps
+    std::vector<int>     rowStart; // row r: dests[rowStart[r] .. rowStart[r + 1])
+    std::vector<StateId> dests;
+
+  public:
+
+    NTable() = default;
+    NTable(const StateIndex &sIdx, const SymbolIndex &vIdx, const NDelta &delta);
+
+    IdSpan destsAt(StateId src, int symIdx) const { // symIdx from SymbolIndex
+      int r = src * (nSymbols + 1) + symIdx;
+      return IdSpan(dests.data() + rowStart[r], dests.data() + rowStart[r + 1]);
+    } // destsAt
+
+    IdSpan epsDestsAt(StateId src) const {
+      return destsAt(src, nSymbols);
+    } // epsDestsAt
+
+}; // NTable
+
+
+class DTable final // no public base class
+       /*OC+*/ : private ObjectCounter<DTable> /*+OC*/ {
+
+  private:
+
+    int                  nSymbols; // columns per state
+    std::vector<StateId> dests;    // dests[src * nSymbols + symIdx]
+
+  public:
+
+    DTable() = default;
+    DTable(const StateIndex &sIdx, const SymbolIndex &vIdx, const DDelta &delta);
+    DTable(int nSymbols, std::vector<StateId> &&dests); // row by row
+
+    int nrOfStates() const {
+      return nSymbols == 0 ? 0 : (int)dests.size() / nSymbols;
+    } // nrOfStates
+
+    int nrOfSymbols() const {
+      return nSymbols;
+    } // nrOfSymbols
+
+    StateId destAt(StateId src, int symIdx) const { // undefId if undefined
+      return dests[src * nSymbols + symIdx];
+    } // destAt
+
+}; // DTable
+
+
+// calls f(from, to) for nThreads ranges of 0 .. n, each in its own
+//   thread, or f(0, n) in the calling thread for small n
+template<typename Func>
+void parallelFor(int n, int nThreads, Func f) {
+  if (nThreads <= 1 || n < 2 * nThreads) {
+    f(0, n);
+    return;
+  } // if
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nThreads; i++)
+    threads.emplace_back(f, (int)((long long)n * i / nThreads),
+                            (int)((long long)n * (i + 1) / nThreads));
+  for (std::thread &t: threads)
+    t.join();
+} // parallelFor
+
+
+// partition of the states of a DFA in integer form into blocks of
+//   equivalent states, computed by Moore-style refinement with nThreads
+//   threads: starts with {final, non-final states} and splits blocks by
+//   signatures (block of state and blocks of its successors, -1 for
+//   undefined) until stable, so undefined transitions differ from
+//   transitions to dead states (as in DFA::minimalOf)
+struct Partition {
+  std::vector<int> blockOf; // StateId -> block, numbered in order of ...
+  int              nBlocks; // ... the first state of each block
+  int              nPasses; // nr. of refinement rounds
+}; // Partition
+
+Partition refinedPartitionOf(const DTable &table,
+                             const std::vector<char> &isFinal, int nThreads);
+
+
+class EpsClosureTable final // no public base class
+                /*OC+*/ : private ObjectCounter<EpsClosureTable> /*+OC*/ {
+  // the strongly connected components (SCCs) of the epsilon graph are
+  //   computed with Tarjan's algorithm, all states of an SCC share one
+  //   closure row, which is the union of the SCC and the closures of its
+  //   successor SCCs (condensation, as Tarjan finds them first)
+
+  private:
+
+    std::vector<int>     sccOf;    // StateId -> SCC = row of closure
+    std::vector<int>     rowStart; // SCC r: closure in dests[rowStart[r] ..
+    std::vector<StateId> dests;    //                       rowStart[r + 1])
+
+  public:
+
+    EpsClosureTable() = default;
+    EpsClosureTable(const NTable &table, int nStates);
+
+    IdSpan closureOf(StateId s) const { // sorted, contains s itself
+      int r = sccOf[s];
+      return IdSpan(dests.data() + rowStart[r], dests.data() + rowStart[r + 1]);
+    } // closureOf
+
+}; // EpsClosureTable
+
+
+typedef std::vector<StateId> Subset; // sorted StateIds
+
+struct SubsetHash {
+  std::size_t operator()(const Subset &ss) const;
+}; // SubsetHash
+
+
+class SubsetTable final // no public base class
+            /*OC+*/ : private ObjectCounter<SubsetTable> /*+OC*/ {
+
+  // the table is split into shards (selected by hash), each with its
+  //   own mutex, so threads inserting different subsets rarely block
+  private:
+
+    static const int nShards = 64;
+
+    struct Shard {
+      std::mutex                                 mtx;
+      std::unordered_map<Subset, int, SubsetHash> ids;
+    }; // Shard
+
+    Shard            shards[nShards];
+    std::atomic<int> nextId;
+
+  public:
+
+    SubsetTable();
+
+    SubsetTable(const SubsetTable &st) = delete;
+    SubsetTable &operator=(const SubsetTable &st) = delete;
+
+    // id of subset ss, inserts ss with the next free id if not yet
+    //   contained, second is true for a newly inserted ss, thread safe
+    std::pair<int, bool> insert(const Subset &ss);
+
+    int size() const; // nr. of subsets = max. id + 1
+
+    // all subsets indexed by their ids, moved out of the table, which is
+    //   empty afterwards, not to be called concurrently with insert
+    std::vector<Subset> takeSubsets();
+
+}; // SubsetTable
+
+
+#endif
+
+// end of TableStuff.h
+//======================================================================
@@ -1,13 +1,23 @@
 /* Timer.c(pp)                                          HDO, 1998-2020
    ----------
    Simple utility to measure run-times for C and C++.
+   For C++ also ScopedTimer (and macro TIME_PHASE) to measure named
+   phases with statistics over all runs of a phase.
 ======================================================================*/
 
 #ifndef __cplusplus
   #include <time.h>
 #else
+  #include <algorithm>
   #include <chrono>
+  #include <cmath>
   #include <ctime>
+  #include <iomanip>
+  #include <iostream>
+  #include <map>
+  #include <mutex>
+  #include <string>
+  #include <vector>
   using namespace std;
 #endif
 
@@ -44,15 +54,103 @@ void stopTimer() {
 
 double elapsed() {
   #ifdef HIGH_RESOLUTION_TIMING
-    return
-      (double)chrono::duration_cast<chrono::milliseconds>(
-        stop_tp - start_tp).count() / 1000.0;
+    return chrono::duration<double>(stop_tp - start_tp).count();
   #else
     return (double)ticks / CLOCKS_PER_SEC;
   #endif
 } /*elapsed*/
 
 
+/* === ScopedTimer and phase statistics ==============================*/
+
+#ifdef __cplusplus
+
+struct PhaseTable;
+static void printPhaseTable(ostream &os, PhaseTable &pt);
+
+/*all samples of all terminated threads, printed on destruction at exit,
+  the main thread's localPhaseTable is already destroyed (and merged)
+  then, so printPhaseTable does not touch it*/
+struct PhaseTable {
+  mutex mtx;
+  map<string, vector<long long>> samples;
+  ~PhaseTable() {
+    if (!samples.empty())
+      printPhaseTable(cout, *this);
+  } /*~PhaseTable*/
+}; /*PhaseTable*/
+
+static PhaseTable &phaseTable() {
+  static PhaseTable pt; /*constructed on first use, also at thread exit*/
+  return pt;
+} /*phaseTable*/
+
+/*samples of one thread, merged into phaseTable at the end of the thread*/
+struct LocalPhaseTable {
+  map<const char *, vector<long long>> samples;
+  void mergeInto(PhaseTable &pt) {
+    if (samples.empty())
+      return;
+    lock_guard<mutex> lock(pt.mtx);
+    for (auto &ps: samples) {
+      vector<long long> &all = pt.samples[ps.first];
+      all.insert(all.end(), ps.second.begin(), ps.second.end());
+    } /*for*/
+    samples.clear();
+  } /*mergeInto*/
+  ~LocalPhaseTable() {
+    mergeInto(phaseTable());
+  } /*~LocalPhaseTable*/
+}; /*LocalPhaseTable*/
+
+static thread_local LocalPhaseTable localPhaseTable;
+
+
+ScopedTimer::ScopedTimer(const char *phase)
+: phase(phase), start_tp(chrono::steady_clock::now()) {
+} /*ScopedTimer::ScopedTimer*/
+
+ScopedTimer::~ScopedTimer() {
+  recordPhaseTime(phase, chrono::duration_cast<chrono::nanoseconds>(
+                           chrono::steady_clock::now() - start_tp).count());
+} /*ScopedTimer::~ScopedTimer*/
+
+
+void recordPhaseTime(const char *phase, long long ns) {
+  localPhaseTable.samples[phase].push_back(ns);
+} /*recordPhaseTime*/
+
+void printPhaseTimes(ostream &os) {
+  PhaseTable &pt = phaseTable();
+  localPhaseTable.mergeInto(pt); /*include samples of calling thread*/
+  printPhaseTable(os, pt);
+} /*printPhaseTimes*/
+
+static void printPhaseTable(ostream &os, PhaseTable &pt) {
+  lock_guard<mutex> lock(pt.mtx);
+  ios_base::fmtflags flags = os.flags();
+  os << endl << "phase times in us:" << endl;
+  os << left << setw(32) << "phase" << right <<
+        setw(8) << "count" << setw(12) << "min" << setw(12) << "median" <<
+        setw(12) << "p99" << setw(12) << "max" << endl;
+  os << fixed << setprecision(1);
+  for (auto &ps: pt.samples) {
+    vector<long long> v = ps.second;
+    sort(v.begin(), v.end());
+    size_t n = v.size();
+    size_t p99 = (size_t)ceil(0.99 * n) - 1;
+    os << left << setw(32) << ps.first << right << setw(8) << n <<
+          setw(12) << v[0]           / 1000.0 <<
+          setw(12) << v[(n - 1) / 2] / 1000.0 <<
+          setw(12) << v[p99]         / 1000.0 <<
+          setw(12) << v[n - 1]       / 1000.0 << endl;
+  } /*for*/
+  os.flags(flags);
+} /*printPhaseTable*/
+
+#endif
+
+
 /* === test ==========================================================*/
 
 #if 0
@@ -1,6 +1,8 @@
 /* Timer.h                                                HDO, 1998-2020
    -------
    Simple utility to measure run-times for C and C++.
+   For C++ also ScopedTimer (and macro TIME_PHASE) to measure named
+   phases with statistics over all runs of a phase.
 ======================================================================*/
 
 #ifndef Timer_h
@@ -20,6 +22,48 @@ double elapsed();    /*returns elapsed time in seconds*/
 #endif
 
 
+#ifdef __cplusplus
+
+#include <chrono>
+#include <iosfwd>
+
+/*ScopedTimer measures the time (in ns) between its construction and its
+  destruction as one sample of a named phase. Samples are collected per
+  thread, so timers in different threads do not interfere, and merged
+  at the end of a thread. At program exit a summary per phase (count,
+  min, median, p99 and max) is printed. Timers can be nested.*/
+
+class ScopedTimer final {
+
+  private:
+
+    const char *phase; /*name of phase, a string literal*/
+    std::chrono::steady_clock::time_point start_tp;
+
+  public:
+
+    explicit ScopedTimer(const char *phase);
+    ScopedTimer(const ScopedTimer &st) = delete;
+    ScopedTimer &operator=(const ScopedTimer &st) = delete;
+    ~ScopedTimer();
+
+}; /*ScopedTimer*/
+
+void recordPhaseTime(const char *phase, long long ns);
+void printPhaseTimes(std::ostream &os); /*summary of all samples so far*/
+
+/*TIME_PHASE(phase) times the rest of the enclosing block if PHASE_TIMING
+  is defined, otherwise it expands to nothing, so instrumented code is
+  not slowed down in normal builds*/
+#ifdef PHASE_TIMING
+  #define TIME_PHASE(phase) ScopedTimer phaseTimer_(phase)
+#else
+  #define TIME_PHASE(phase)
+#endif
+
+#endif
+
+
 #endif
 
 /*end of Timer.h